@@ -0,0 +1,674 @@
+/*
+ * msdfgen-bench: times each stage of the C API on a fixed corpus and prints JSON
+ *
+ * Usage: msdfgen-bench [--corpus DIR] [--font FILE]... [--filter TEXT] [--min-time SECONDS] [--output FILE] [--verify]
+ *
+ * The corpus consists of synthetic shapes built in code plus the SVG files and any
+ * TrueType/OpenType fonts found in the corpus directory. Every benchmark is run until
+ * it has taken at least the minimum time, and reports per-iteration statistics.
+ * With --verify, the fields of the alternative generation paths are compared against
+ * stock msdfgen on the shapes of the corpus instead, and the exit status is nonzero
+ * on any mismatch.
+ */
+
+#include "msdfgen_c_api.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifndef MSDFGEN_BENCH_CORPUS_DIR
+#define MSDFGEN_BENCH_CORPUS_DIR "bench/corpus"
+#endif
+
+#define MSDFGEN_BENCH_PI 3.14159265358979323846
+
+/* ============================================================================
+ * Measurement
+ * ============================================================================ */
+
+struct Result {
+    std::string name;
+    int items;              /* Units of work per iteration, e.g. glyphs */
+    int iterations;
+    double minNs;
+    double medianNs;
+    double meanNs;
+};
+
+struct Options {
+    std::string corpus = MSDFGEN_BENCH_CORPUS_DIR;
+    std::vector<std::string> fonts;
+    std::string filter;
+    std::string output;
+    double minTime = 0.25;
+    bool verify = false;
+};
+
+class Bench {
+
+public:
+    explicit Bench(const Options& options) : options(options) { }
+
+    /* Runs body once to warm up, then repeatedly for at least the minimum time */
+    void measure(const std::string& name, int items, const std::function<void()>& body) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+        typedef std::chrono::steady_clock Clock;
+        body();
+        std::vector<double> samples;
+        Clock::time_point start = Clock::now();
+        do {
+            Clock::time_point before = Clock::now();
+            body();
+            samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - before).count());
+        } while (std::chrono::duration<double>(Clock::now() - start).count() < options.minTime && samples.size() < 1000000);
+
+        std::sort(samples.begin(), samples.end());
+        double total = 0;
+        for (double sample : samples) {
+            total += sample;
+        }
+        size_t count = samples.size();
+        Result result;
+        result.name = name;
+        result.items = items;
+        result.iterations = static_cast<int>(count);
+        result.minNs = samples.front();
+        result.medianNs = count % 2 ? samples[count / 2] : .5 * (samples[count / 2 - 1] + samples[count / 2]);
+        result.meanNs = total / count;
+        results.push_back(result);
+        fprintf(stderr, "%-48s %14.0f ns\n", name.c_str(), result.medianNs);
+    }
+
+    void skip(const std::string& name, const char* reason) {
+        skipped.push_back(name + ": " + reason);
+    }
+
+    void writeJson(FILE* file) const;
+
+private:
+    const Options& options;
+    std::vector<Result> results;
+    std::vector<std::string> skipped;
+
+};
+
+static void writeJsonString(FILE* file, const std::string& text) {
+    fputc('"', file);
+    for (char c : text) {
+        switch (c) {
+            case '"': fputs("\\\"", file); break;
+            case '\\': fputs("\\\\", file); break;
+            case '\n': fputs("\\n", file); break;
+            case '\t': fputs("\\t", file); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    fprintf(file, "\\u%04x", c);
+                } else {
+                    fputc(c, file);
+                }
+        }
+    }
+    fputc('"', file);
+}
+
+void Bench::writeJson(FILE* file) const {
+    fprintf(file, "{\n  \"version\": ");
+    writeJsonString(file, msdfgen_get_version());
+    fprintf(file, ",\n  \"extensions\": %d,\n  \"parallel_generation\": %d,\n  \"threads\": %d,\n  \"min_time\": %g,\n",
+        msdfgen_has_extension_support(), msdfgen_has_parallel_generation(), msdfgen_get_thread_count(), options.minTime);
+    fprintf(file, "  \"results\": [");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        fprintf(file, "%s\n    {\"name\": ", i ? "," : "");
+        writeJsonString(file, result.name);
+        fprintf(file, ", \"items\": %d, \"iterations\": %d, \"min_ns\": %.0f, \"median_ns\": %.0f, \"mean_ns\": %.0f}",
+            result.items, result.iterations, result.minNs, result.medianNs, result.meanNs);
+    }
+    fprintf(file, "%s],\n  \"skipped\": [", results.empty() ? "" : "\n  ");
+    for (size_t i = 0; i < skipped.size(); i++) {
+        fprintf(file, "%s\n    ", i ? "," : "");
+        writeJsonString(file, skipped[i]);
+    }
+    fprintf(file, "%s]\n}\n", skipped.empty() ? "" : "\n  ");
+}
+
+/* ============================================================================
+ * Synthetic corpus
+ * ============================================================================ */
+
+struct Path {
+    std::string name;
+    std::vector<unsigned char> verbs;
+    std::vector<double> points;
+
+    void moveTo(double x, double y) { add(MSDFGEN_VERB_MOVE, {x, y}); }
+    void lineTo(double x, double y) { add(MSDFGEN_VERB_LINE, {x, y}); }
+    void quadraticTo(double x1, double y1, double x2, double y2) { add(MSDFGEN_VERB_QUADRATIC, {x1, y1, x2, y2}); }
+    void cubicTo(double x1, double y1, double x2, double y2, double x3, double y3) { add(MSDFGEN_VERB_CUBIC, {x1, y1, x2, y2, x3, y3}); }
+    void close() { verbs.push_back(MSDFGEN_VERB_CLOSE); }
+
+private:
+    void add(MsdfgenPathVerb verb, std::initializer_list<double> coordinates) {
+        verbs.push_back(static_cast<unsigned char>(verb));
+        points.insert(points.end(), coordinates);
+    }
+};
+
+/* Closed polygon of alternating outer and inner vertices */
+static Path starPath(int spikes) {
+    Path path;
+    path.name = "star" + std::to_string(spikes);
+    for (int i = 0; i < 2 * spikes; i++) {
+        double angle = MSDFGEN_BENCH_PI * i / spikes;
+        double radius = i % 2 ? 40 : 100;
+        if (i == 0) {
+            path.moveTo(radius * cos(angle), radius * sin(angle));
+        } else {
+            path.lineTo(radius * cos(angle), radius * sin(angle));
+        }
+    }
+    path.close();
+    return path;
+}
+
+/* Circle of four cubic arcs, clockwise if reverse */
+static void addCircle(Path& path, double radius, bool reverse) {
+    const double k = 0.5522847498 * radius;
+    double s = reverse ? -1 : 1;
+    path.moveTo(radius, 0);
+    path.cubicTo(radius, s * k, k, s * radius, 0, s * radius);
+    path.cubicTo(-k, s * radius, -radius, s * k, -radius, 0);
+    path.cubicTo(-radius, -s * k, -k, -s * radius, 0, -s * radius);
+    path.cubicTo(k, -s * radius, radius, -s * k, radius, 0);
+    path.close();
+}
+
+static Path ringPath() {
+    Path path;
+    path.name = "ring";
+    addCircle(path, 100, false);
+    addCircle(path, 60, true);
+    return path;
+}
+
+/* Wavy outline of quadratic segments */
+static Path blobPath(int segments) {
+    Path path;
+    path.name = "blob" + std::to_string(segments);
+    for (int i = 0; i <= segments; i++) {
+        double angle = 2 * MSDFGEN_BENCH_PI * i / segments;
+        double radius = 100 + 12 * sin(5 * angle);
+        double x = radius * cos(angle), y = radius * sin(angle);
+        if (i == 0) {
+            path.moveTo(x, y);
+        } else {
+            double middle = angle - MSDFGEN_BENCH_PI / segments;
+            double controlRadius = (100 + 12 * sin(5 * middle)) / cos(MSDFGEN_BENCH_PI / segments);
+            path.quadraticTo(controlRadius * cos(middle), controlRadius * sin(middle), x, y);
+        }
+    }
+    path.close();
+    return path;
+}
+
+static std::vector<Path> syntheticPaths() {
+    std::vector<Path> paths;
+    paths.push_back(starPath(5));
+    paths.push_back(ringPath());
+    paths.push_back(blobPath(48));
+    paths.push_back(starPath(512));
+    return paths;
+}
+
+/* Adds the path edge by edge, as bindings without the bulk entry point do */
+static void buildEdgeByEdge(MsdfgenShape shape, const Path& path) {
+    const double* p = path.points.data();
+    double x = 0, y = 0;
+    int contour = -1;
+    for (unsigned char verb : path.verbs) {
+        switch (verb) {
+            case MSDFGEN_VERB_MOVE:
+                contour = msdfgen_shape_add_contour(shape);
+                x = p[0], y = p[1];
+                p += 2;
+                break;
+            case MSDFGEN_VERB_LINE:
+                msdfgen_contour_add_linear(shape, contour, x, y, p[0], p[1]);
+                x = p[0], y = p[1];
+                p += 2;
+                break;
+            case MSDFGEN_VERB_QUADRATIC:
+                msdfgen_contour_add_quadratic(shape, contour, x, y, p[0], p[1], p[2], p[3]);
+                x = p[2], y = p[3];
+                p += 4;
+                break;
+            case MSDFGEN_VERB_CUBIC:
+                msdfgen_contour_add_cubic(shape, contour, x, y, p[0], p[1], p[2], p[3], p[4], p[5]);
+                x = p[4], y = p[5];
+                p += 6;
+                break;
+        }
+    }
+}
+
+static MsdfgenShape buildShape(const Path& path) {
+    MsdfgenShape shape = msdfgen_shape_create();
+    msdfgen_shape_build_from_arrays(shape, path.verbs.data(), static_cast<int>(path.verbs.size()), path.points.data(), static_cast<int>(path.points.size() / 2));
+    msdfgen_shape_normalize(shape);
+    msdfgen_edge_coloring_simple(shape, 3.0, 0);
+    return shape;
+}
+
+/* ============================================================================
+ * Stages
+ * ============================================================================ */
+
+static void benchShapes(Bench& bench, const std::vector<Path>& paths) {
+    MsdfgenShape shape = msdfgen_shape_create();
+    for (const Path& path : paths) {
+        int edges = static_cast<int>(path.verbs.size());
+        bench.measure("shape/build_edges/" + path.name, edges, [&]() {
+            msdfgen_shape_reset(shape);
+            buildEdgeByEdge(shape, path);
+        });
+        bench.measure("shape/build_arrays/" + path.name, edges, [&]() {
+            msdfgen_shape_reset(shape);
+            msdfgen_shape_build_from_arrays(shape, path.verbs.data(), static_cast<int>(path.verbs.size()), path.points.data(), static_cast<int>(path.points.size() / 2));
+        });
+        bench.measure("shape/normalize/" + path.name, edges, [&]() {
+            msdfgen_shape_normalize(shape);
+        });
+        bench.measure("coloring/simple/" + path.name, edges, [&]() {
+            msdfgen_edge_coloring_simple(shape, 3.0, 0);
+        });
+        bench.measure("coloring/ink_trap/" + path.name, edges, [&]() {
+            msdfgen_edge_coloring_ink_trap(shape, 3.0, 0);
+        });
+        bench.measure("coloring/by_distance/" + path.name, edges, [&]() {
+            msdfgen_edge_coloring_by_distance(shape, 3.0, 0);
+        });
+    }
+    msdfgen_shape_destroy(shape);
+}
+
+static void benchGeneration(Bench& bench, const std::vector<Path>& paths) {
+    static const struct {
+        MsdfgenBitmapType type;
+        const char* name;
+        int channels;
+    } types[] = {
+        {MSDFGEN_BITMAP_SDF, "sdf", 1},
+        {MSDFGEN_BITMAP_PSDF, "psdf", 1},
+        {MSDFGEN_BITMAP_MSDF, "msdf", 3},
+        {MSDFGEN_BITMAP_MTSDF, "mtsdf", 4}
+    };
+    static const int sizes[] = {32, 64, 128, 256};
+
+    MsdfgenGeneratorConfig config = msdfgen_generator_config_default();
+    std::vector<float> pixels;
+    for (const Path& path : paths) {
+        MsdfgenShape shape = buildShape(path);
+        for (const auto& type : types) {
+            for (int size : sizes) {
+                double scaleX, scaleY, translateX, translateY;
+                msdfgen_auto_frame(shape, size, size, 4.0, &scaleX, &scaleY, &translateX, &translateY);
+                pixels.resize(static_cast<size_t>(size) * size * type.channels);
+                bench.measure(std::string("generate/") + type.name + "/" + std::to_string(size) + "/" + path.name, size * size, [&]() {
+                    msdfgen_generate_into_format(shape, type.type, MSDFGEN_PIXEL_FLOAT32, pixels.data(), size, size, 0, scaleX, scaleY, translateX, translateY, 4.0, &config);
+                });
+            }
+        }
+        msdfgen_shape_destroy(shape);
+    }
+}
+
+static void benchErrorCorrection(Bench& bench, const std::vector<Path>& paths) {
+    static const struct {
+        MsdfgenErrorCorrectionMode mode;
+        const char* name;
+    } modes[] = {
+        {MSDFGEN_ERROR_CORRECTION_DISABLED, "disabled"},
+        {MSDFGEN_ERROR_CORRECTION_INDISCRIMINATE, "indiscriminate"},
+        {MSDFGEN_ERROR_CORRECTION_EDGE_PRIORITY, "edge_priority"},
+        {MSDFGEN_ERROR_CORRECTION_EDGE_ONLY, "edge_only"}
+    };
+    static const struct {
+        MsdfgenDistanceCheckMode mode;
+        const char* name;
+    } checks[] = {
+        {MSDFGEN_DISTANCE_CHECK_NONE, "no_check"},
+        {MSDFGEN_DISTANCE_CHECK_AT_EDGE, "check_at_edge"},
+        {MSDFGEN_DISTANCE_CHECK_ALWAYS, "check_always"}
+    };
+    const int size = 64;
+
+    std::vector<float> pixels(static_cast<size_t>(size) * size * 3);
+    for (const Path& path : paths) {
+        MsdfgenShape shape = buildShape(path);
+        double scaleX, scaleY, translateX, translateY;
+        msdfgen_auto_frame(shape, size, size, 4.0, &scaleX, &scaleY, &translateX, &translateY);
+        for (const auto& mode : modes) {
+            for (const auto& check : checks) {
+                if (mode.mode == MSDFGEN_ERROR_CORRECTION_DISABLED && check.mode != MSDFGEN_DISTANCE_CHECK_NONE) continue;
+                MsdfgenGeneratorConfig config = msdfgen_generator_config_default();
+                config.errorCorrection.mode = mode.mode;
+                config.errorCorrection.distanceCheckMode = check.mode;
+                bench.measure(std::string("error_correction/") + mode.name + "/" + check.name + "/" + path.name, size * size, [&]() {
+                    msdfgen_generate_msdf_into(shape, pixels.data(), size, size, 0, scaleX, scaleY, translateX, translateY, 4.0, &config);
+                });
+            }
+        }
+        msdfgen_shape_destroy(shape);
+    }
+}
+
+static void benchConversion(Bench& bench) {
+    static const int sizes[] = {256, 1024};
+    for (int size : sizes) {
+        std::vector<float> values(static_cast<size_t>(size) * size * 3);
+        unsigned state = 1;
+        for (float& value : values) {
+            state = state * 1664525u + 1013904223u;
+            value = static_cast<float>(state >> 8) / 16777216.0f * 1.5f - .25f;
+        }
+        std::vector<unsigned char> bytes(values.size());
+        MsdfgenBitmap bitmap = {values.data(), size, size, 3, 1};
+        bench.measure("convert/bitmap_to_bytes/" + std::to_string(size), size * size, [&]() {
+            msdfgen_bitmap_to_bytes(&bitmap, bytes.data(), 128);
+        });
+    }
+}
+
+static std::vector<std::string> corpusFiles(const std::string& directory, std::initializer_list<const char*> extensions) {
+    std::vector<std::string> files;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(tolower(c)); });
+        for (const char* accepted : extensions) {
+            if (extension == accepted) {
+                files.push_back(entry.path().string());
+            }
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static std::string fileName(const std::string& path) {
+    return std::filesystem::path(path).filename().string();
+}
+
+static void benchFonts(Bench& bench, const Options& options) {
+    std::vector<std::string> fonts = options.fonts;
+    if (fonts.empty()) {
+        fonts = corpusFiles(options.corpus, {".ttf", ".otf"});
+    }
+    if (!msdfgen_has_extension_support()) {
+        bench.skip("font", "built without extensions");
+        return;
+    }
+    if (fonts.empty()) {
+        bench.skip("font", "no fonts in the corpus directory or given with --font");
+        return;
+    }
+
+    MsdfgenFreetype freetype = msdfgen_freetype_init();
+    MsdfgenShape shape = msdfgen_shape_create();
+    for (const std::string& filename : fonts) {
+        MsdfgenFont font = msdfgen_font_load(freetype, filename.c_str());
+        if (!font) {
+            bench.skip("font/" + fileName(filename), "failed to load");
+            continue;
+        }
+        // Printable ASCII, the bulk of most text atlases
+        bench.measure("font/load_glyph/" + fileName(filename), 94, [&]() {
+            for (unsigned codepoint = 33; codepoint < 127; codepoint++) {
+                msdfgen_font_load_glyph(shape, font, codepoint, MSDFGEN_FONT_SCALING_EM_NORMALIZED, nullptr);
+            }
+        });
+        msdfgen_font_destroy(font);
+    }
+    msdfgen_shape_destroy(shape);
+    msdfgen_freetype_deinit(freetype);
+}
+
+static void benchSvg(Bench& bench, const Options& options) {
+    if (!msdfgen_has_extension_support()) {
+        bench.skip("svg", "built without extensions");
+        return;
+    }
+    std::vector<std::string> files = corpusFiles(options.corpus, {".svg"});
+    if (files.empty()) {
+        bench.skip("svg", "no SVG files in the corpus directory");
+        return;
+    }
+    MsdfgenShape shape = msdfgen_shape_create();
+    for (const std::string& filename : files) {
+        MsdfgenBounds viewBox;
+        bench.measure("svg/load/" + fileName(filename), 1, [&]() {
+            msdfgen_shape_reset(shape);
+            msdfgen_shape_load_from_svg_file_ex(shape, &viewBox, filename.c_str());
+        });
+    }
+    msdfgen_shape_destroy(shape);
+}
+
+/* ============================================================================
+ * Verification
+ * ============================================================================ */
+
+/* Process-wide settings that select a generation path */
+struct GenerationPath {
+    const char* name;
+    MsdfgenDistancePrecision precision;
+    MsdfgenDistanceAcceleration acceleration;
+    MsdfgenBandCulling bandCulling;
+    bool sdfOnly;       /* Only SDF generation is compared */
+    bool clamped;       /* Values beyond the range are clamped to 0 and 1 */
+};
+
+/* Stock msdfgen generators: double precision, every edge of every pixel */
+static const GenerationPath referencePath = {"reference", MSDFGEN_PRECISION_DOUBLE, MSDFGEN_ACCELERATION_DISABLED, MSDFGEN_BAND_CULLING_DISABLED, false, false};
+
+static const GenerationPath verifiedPaths[] = {
+    {"float", MSDFGEN_PRECISION_FLOAT, MSDFGEN_ACCELERATION_DISABLED, MSDFGEN_BAND_CULLING_DISABLED, false, false},
+    {"edge_bvh", MSDFGEN_PRECISION_DOUBLE, MSDFGEN_ACCELERATION_ALWAYS, MSDFGEN_BAND_CULLING_DISABLED, true, false},
+    {"band_culling", MSDFGEN_PRECISION_DOUBLE, MSDFGEN_ACCELERATION_DISABLED, MSDFGEN_BAND_CULLING_ENABLED, true, true},
+    {"band_culling_bvh", MSDFGEN_PRECISION_DOUBLE, MSDFGEN_ACCELERATION_ALWAYS, MSDFGEN_BAND_CULLING_ENABLED, true, true}
+};
+
+/* Generates a field with error correction disabled, so only the distance stage is compared */
+static std::vector<float> generateWithPath(MsdfgenShape shape, MsdfgenBitmapType type, int channels, int size, bool overlapSupport, const GenerationPath& path) {
+    msdfgen_set_distance_precision(path.precision);
+    msdfgen_set_distance_acceleration(path.acceleration);
+    msdfgen_set_band_culling(path.bandCulling);
+    MsdfgenGeneratorConfig config = msdfgen_generator_config_default();
+    config.overlapSupport = overlapSupport;
+    config.errorCorrection.mode = MSDFGEN_ERROR_CORRECTION_DISABLED;
+    double scaleX, scaleY, translateX, translateY;
+    msdfgen_auto_frame(shape, size, size, 4.0, &scaleX, &scaleY, &translateX, &translateY);
+    std::vector<float> pixels(static_cast<size_t>(size) * size * channels);
+    if (!msdfgen_generate_into_format(shape, type, MSDFGEN_PIXEL_FLOAT32, pixels.data(), size, size, 0, scaleX, scaleY, translateX, translateY, 4.0, &config)) {
+        pixels.clear();
+    }
+    return pixels;
+}
+
+/* Largest difference between the fields in pixels of distance, infinite if either failed */
+static double fieldDifference(const std::vector<float>& reference, const std::vector<float>& field, bool clamped) {
+    if (reference.empty() || field.size() != reference.size()) return HUGE_VAL;
+    double difference = 0;
+    for (size_t i = 0; i < field.size(); i++) {
+        float expected = clamped ? std::min(std::max(reference[i], 0.0f), 1.0f) : reference[i];
+        difference = std::max(difference, 4.0 * fabs(field[i] - expected));
+    }
+    return difference;
+}
+
+/*
+ * Largest difference between the distances multi-channel fields decode to: the median of
+ * the color channels and, in an MTSDF, the true distance. Where two edges are within float
+ * rounding of each other a single channel may follow the other one; the values that differ
+ * by more than the tolerance are counted in deviations.
+ */
+static double decodedDifference(const std::vector<float>& reference, const std::vector<float>& field, int channels, double tolerance, size_t& deviations) {
+    deviations = 0;
+    if (reference.empty() || field.size() != reference.size()) return HUGE_VAL;
+    auto median = [](const float* pixel) {
+        return std::max(std::min(pixel[0], pixel[1]), std::min(std::max(pixel[0], pixel[1]), pixel[2]));
+    };
+    double difference = 0;
+    for (size_t i = 0; i < field.size(); i += channels) {
+        difference = std::max(difference, 4.0 * fabs(median(&field[i]) - median(&reference[i])));
+        if (channels == 4) {
+            difference = std::max(difference, 4.0 * fabs(field[i + 3] - reference[i + 3]));
+        }
+        for (int c = 0; c < channels; c++) {
+            deviations += 4.0 * fabs(field[i + c] - reference[i + c]) > tolerance;
+        }
+    }
+    return difference;
+}
+
+/*
+ * Compares every path against the reference on one shape and returns the number of
+ * mismatches. Float precision may deviate by 1e-6 of the field's extent (at least
+ * 1e-4 pixels). In multi-channel fields this applies to the decoded distance, and at
+ * most 1% of the values may deviate further. The double precision paths must give
+ * exactly the reference values, clamped to 0 and 1 where the path clamps them.
+ */
+static int verifyShape(const std::string& name, MsdfgenShape shape) {
+    static const struct {
+        MsdfgenBitmapType type;
+        const char* name;
+        int channels;
+    } types[] = {
+        {MSDFGEN_BITMAP_SDF, "sdf", 1},
+        {MSDFGEN_BITMAP_MSDF, "msdf", 3},
+        {MSDFGEN_BITMAP_MTSDF, "mtsdf", 4}
+    };
+    static const int sizes[] = {32, 64, 128};
+
+    int failures = 0;
+    for (const auto& type : types) {
+        for (int size : sizes) {
+            for (int overlapSupport = 0; overlapSupport <= 1; overlapSupport++) {
+                std::vector<float> reference = generateWithPath(shape, type.type, type.channels, size, overlapSupport != 0, referencePath);
+                for (const GenerationPath& path : verifiedPaths) {
+                    if (path.sdfOnly && type.type != MSDFGEN_BITMAP_SDF) continue;
+                    std::vector<float> field = generateWithPath(shape, type.type, type.channels, size, overlapSupport != 0, path);
+                    double tolerance = path.precision == MSDFGEN_PRECISION_FLOAT ? std::max(1e-4, 1e-6 * size) : 0;
+                    size_t deviations = 0;
+                    double difference = type.channels > 1 && path.precision == MSDFGEN_PRECISION_FLOAT
+                        ? decodedDifference(reference, field, type.channels, tolerance, deviations)
+                        : fieldDifference(reference, field, path.clamped);
+                    bool passed = difference <= tolerance && deviations <= field.size() / 100;
+                    failures += !passed;
+                    fprintf(stderr, "%-4s %s/%s/%d/%s%s: %.3g px, %zu values deviate\n", passed ? "ok" : "FAIL",
+                        path.name, type.name, size, name.c_str(), overlapSupport ? "/overlap" : "", difference, deviations);
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+/* Checks the generation paths against stock msdfgen on the corpus */
+static int verify(const Options& options) {
+    int failures = 0;
+    for (const Path& path : syntheticPaths()) {
+        MsdfgenShape shape = buildShape(path);
+        failures += verifyShape(path.name, shape);
+        msdfgen_shape_destroy(shape);
+    }
+    if (msdfgen_has_extension_support()) {
+        for (const std::string& filename : corpusFiles(options.corpus, {".svg"})) {
+            MsdfgenShape shape = msdfgen_shape_create();
+            MsdfgenBounds viewBox;
+            if (msdfgen_shape_load_from_svg_file_ex(shape, &viewBox, filename.c_str())) {
+                msdfgen_shape_normalize(shape);
+                msdfgen_edge_coloring_simple(shape, 3.0, 0);
+                failures += verifyShape(fileName(filename), shape);
+            } else {
+                fprintf(stderr, "FAIL cannot load %s\n", filename.c_str());
+                failures++;
+            }
+            msdfgen_shape_destroy(shape);
+        }
+    }
+    msdfgen_set_distance_precision(MSDFGEN_PRECISION_DOUBLE);
+    msdfgen_set_distance_acceleration(MSDFGEN_ACCELERATION_AUTO);
+    msdfgen_set_band_culling(MSDFGEN_BAND_CULLING_DISABLED);
+    fprintf(stderr, "%d mismatch%s\n", failures, failures == 1 ? "" : "es");
+    return failures;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+static bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--verify") {
+            options.verify = true;
+            continue;
+        }
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        if (argument == "--corpus") {
+            options.corpus = value;
+        } else if (argument == "--font") {
+            options.fonts.push_back(value);
+        } else if (argument == "--filter") {
+            options.filter = value;
+        } else if (argument == "--min-time") {
+            options.minTime = atof(value);
+        } else if (argument == "--output") {
+            options.output = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        fprintf(stderr, "Usage: %s [--corpus DIR] [--font FILE]... [--filter TEXT] [--min-time SECONDS] [--output FILE] [--verify]\n", argv[0]);
+        return 1;
+    }
+    if (options.verify) {
+        return verify(options) ? 1 : 0;
+    }
+
+    Bench bench(options);
+    std::vector<Path> paths = syntheticPaths();
+    benchShapes(bench, paths);
+    benchGeneration(bench, paths);
+    benchErrorCorrection(bench, paths);
+    benchConversion(bench);
+    benchFonts(bench, options);
+    benchSvg(bench, options);
+
+    FILE* file = options.output.empty() ? stdout : fopen(options.output.c_str(), "w");
+    if (!file) {
+        fprintf(stderr, "Cannot write %s\n", options.output.c_str());
+        return 1;
+    }
+    bench.writeJson(file);
+    if (file != stdout) {
+        fclose(file);
+    }
+    return 0;
+}
@@ -3,18 +3,87 @@
  */
 
 #include "msdfgen_c_api.h"
+#include "msdfgen_c_atlas_packer.h"
+#include "msdfgen_c_band_sdf.h"
+#include "msdfgen_c_convert.h"
+#include "msdfgen_c_disk_cache.h"
+#include "msdfgen_c_distance_packet.h"
+#include "msdfgen_c_edge_bvh.h"
+#include "msdfgen_c_fill_sign.h"
+#include "msdfgen_c_flat_shape.h"
+#include "msdfgen_c_font.h"
+#include "msdfgen_c_hash.h"
+#include "msdfgen_c_job_queue.h"
+#include "msdfgen_c_memory_cache.h"
+#include "msdfgen_c_pooled_shape.h"
+#include "msdfgen_c_stats.h"
+#include "msdfgen_c_thread_pool.h"
 #include "msdfgen.h"
 
 #ifdef MSDFGEN_USE_EXTENSIONS
 #include "msdfgen-ext.h"
 #endif
 
+#ifdef MSDFGEN_USE_OPENMP
+#include <omp.h>
+#endif
+
+#include <climits>
+#include <cstddef>
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 using namespace msdfgen;
+using msdfgen_c::CacheKey;
+using msdfgen_c::DiskCache;
+using msdfgen_c::Hasher;
+using msdfgen_c::Job;
+using msdfgen_c::JobQueue;
+using msdfgen_c::MemoryCache;
+using msdfgen_c::PooledShape;
+using msdfgen_c::StageTimer;
+using msdfgen_c::ThreadPool;
+using msdfgen_c::convertToBytes;
+using msdfgen_c::convertToHalf;
+using msdfgen_c::packRectangles;
+using msdfgen_c::quantizeToUnorm16;
+using msdfgen_c::quantizeToUnorm8;
+using msdfgen_c::segmentPoints;
+using msdfgen_c::statsActive;
+using msdfgen_c::threadStats;
+
+/* Images with at least this many pixels are converted to bytes on several threads */
+#define MSDFGEN_C_PARALLEL_CONVERSION_PIXELS (1 << 18)
+
+/* Smallest edge count for which MSDFGEN_ACCELERATION_AUTO builds an edge hierarchy */
+#define MSDFGEN_C_BVH_MIN_EDGES 64
+
+/* Fields with fewer pixels are generated on the calling thread only */
+#define MSDFGEN_C_PARALLEL_GENERATION_PIXELS (1 << 14)
+
+/* Size in pixels of the float buffer a field is generated through when it is not stored as packed floats */
+#define MSDFGEN_C_STRIP_PIXELS (1 << 18)
+
+/*
+ * Revision of the generated pixels, part of every result cache key and of the disk
+ * cache header. Bump it with any change to a generator or correction pass that
+ * alters its output, so that results of an older build are never reused.
+ */
+#define MSDFGEN_C_GENERATOR_REVISION 2
+
+/* Version of the msdfgen sources the library is built from, set by the build */
+#ifndef MSDFGEN_C_MSDFGEN_VERSION
+#define MSDFGEN_C_MSDFGEN_VERSION "unknown"
+#endif
 
 /* ============================================================================
  * Internal helpers
@@ -59,29 +128,749 @@ static MSDFGeneratorConfig toMSDFGeneratorConfig(const MsdfgenGeneratorConfig* c
     return MSDFGeneratorConfig(config->overlapSupport != 0, toErrorCorrectionConfig(config->errorCorrection));
 }
 
-template<int N>
-static MsdfgenBitmap createBitmapResult(const Bitmap<float, N>& bitmap) {
-    MsdfgenBitmap result = {nullptr, 0, 0, 0, 0};
-    int width = bitmap.width();
-    int height = bitmap.height();
+static FillRule toFillRule(MsdfgenFillRule rule) {
+    switch (rule) {
+        case MSDFGEN_FILL_ODD: return FILL_ODD;
+        case MSDFGEN_FILL_POSITIVE: return FILL_POSITIVE;
+        case MSDFGEN_FILL_NEGATIVE: return FILL_NEGATIVE;
+        case MSDFGEN_FILL_NONZERO:
+        default: return FILL_NONZERO;
+    }
+}
 
-    size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height) * N;
-    result.pixels = static_cast<float*>(malloc(pixelCount * sizeof(float)));
-    if (result.pixels) {
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                const float* src = bitmap(x, y);
-                float* dst = result.pixels + (y * width + x) * N;
-                for (int c = 0; c < N; c++) {
-                    dst[c] = src[c];
+#ifdef MSDFGEN_USE_EXTENSIONS
+static FontHandle* fontHandle(MsdfgenFont font) {
+    return static_cast<msdfgen_c::Font*>(font)->handle;
+}
+#endif
+
+/* Every MsdfgenShape handed out by msdfgen_shape_create is a PooledShape */
+static PooledShape* toPooledShape(MsdfgenShape handle) {
+    return static_cast<PooledShape*>(static_cast<Shape*>(handle));
+}
+
+static SDFTransformation toSDFTransformation(double scaleX, double scaleY, double translateX, double translateY, double rangePixels) {
+    Vector2 scale(scaleX, scaleY);
+    Vector2 translate(translateX, translateY);
+    Projection projection(scale, translate);
+    Range range(rangePixels / std::min(scaleX, scaleY));
+    return SDFTransformation(projection, range);
+}
+
+static int bitmapChannels(MsdfgenBitmapType type) {
+    switch (type) {
+        case MSDFGEN_BITMAP_SDF:
+        case MSDFGEN_BITMAP_PSDF: return 1;
+        case MSDFGEN_BITMAP_MSDF: return 3;
+        case MSDFGEN_BITMAP_MTSDF: return 4;
+    }
+    return 0;
+}
+
+static size_t pixelFormatSize(MsdfgenPixelFormat format) {
+    switch (format) {
+        case MSDFGEN_PIXEL_FLOAT32: return sizeof(float);
+        case MSDFGEN_PIXEL_UINT8: return 1;
+        case MSDFGEN_PIXEL_UINT16:
+        case MSDFGEN_PIXEL_FLOAT16: return 2;
+    }
+    return 0;
+}
+
+static void storeValues(void* dst, MsdfgenPixelFormat format, const float* src, size_t count) {
+    switch (format) {
+        case MSDFGEN_PIXEL_FLOAT32:
+            memcpy(dst, src, count * sizeof(float));
+            break;
+        case MSDFGEN_PIXEL_UINT8:
+            quantizeToUnorm8(src, static_cast<unsigned char*>(dst), count);
+            break;
+        case MSDFGEN_PIXEL_UINT16:
+            quantizeToUnorm16(src, static_cast<unsigned short*>(dst), count);
+            break;
+        case MSDFGEN_PIXEL_FLOAT16:
+            convertToHalf(src, static_cast<unsigned short*>(dst), count);
+            break;
+    }
+}
+
+static std::atomic<int> distanceAcceleration(MSDFGEN_ACCELERATION_AUTO);
+
+static bool useEdgeBvh(const Shape& shape) {
+    switch (distanceAcceleration.load(std::memory_order_relaxed)) {
+        case MSDFGEN_ACCELERATION_DISABLED: return false;
+        case MSDFGEN_ACCELERATION_ALWAYS: return true;
+    }
+    return shape.edgeCount() >= MSDFGEN_C_BVH_MIN_EDGES;
+}
+
+/* 0 while the scanline sign is disabled, otherwise 1 + its MsdfgenFillRule */
+static std::atomic<int> scanlineSign(0);
+
+/* The config distances are generated with; with scanline signs, the fill resolves overlapping contours afterwards */
+static MsdfgenGeneratorConfig distanceStageConfig(const MsdfgenGeneratorConfig& config, int sign) {
+    MsdfgenGeneratorConfig result = config;
+    if (sign) {
+        result.overlapSupport = 0;
+    }
+    return result;
+}
+
+/* The config error correction runs with; after scanline signs, it checks no distances, like msdfgen's scanline pass */
+static MsdfgenGeneratorConfig correctionStageConfig(const MsdfgenGeneratorConfig& config, int sign) {
+    MsdfgenGeneratorConfig result = distanceStageConfig(config, sign);
+    if (sign) {
+        result.errorCorrection.distanceCheckMode = MSDFGEN_DISTANCE_CHECK_NONE;
+    }
+    return result;
+}
+
+static std::atomic<int> distancePrecision(MSDFGEN_PRECISION_DOUBLE);
+
+/* Whether distances of this generation are evaluated by the single precision kernels; the edge hierarchy takes precedence */
+static bool useSinglePrecision(MsdfgenBitmapType type, const Shape& shape, const MsdfgenGeneratorConfig& config) {
+    if (distancePrecision.load(std::memory_order_relaxed) != MSDFGEN_PRECISION_FLOAT) return false;
+    switch (type) {
+        case MSDFGEN_BITMAP_SDF: return config.overlapSupport || !useEdgeBvh(shape);
+        case MSDFGEN_BITMAP_MSDF:
+        case MSDFGEN_BITMAP_MTSDF: return true;
+        default: return false;
+    }
+}
+
+static std::atomic<int> bandCulling(MSDFGEN_BAND_CULLING_DISABLED);
+
+/* Whether SDF pixels beyond the range are filled by the coarse-to-fine generator; the single precision kernels take precedence */
+static bool useBandCulling(MsdfgenBitmapType type, const Shape& shape, const MsdfgenGeneratorConfig& config) {
+    return type == MSDFGEN_BITMAP_SDF && !useSinglePrecision(type, shape, config)
+        && bandCulling.load(std::memory_order_relaxed) == MSDFGEN_BAND_CULLING_ENABLED;
+}
+
+static std::atomic<int> threadCountSetting(0);
+static std::atomic<int> activeGenerators(0);
+
+/* Thread count of a parallel call: the explicit count if positive, else the process-wide setting (0 = all hardware threads) */
+static int resolveThreadCount(int threadCount) {
+    return threadCount > 0 ? threadCount : threadCountSetting.load(std::memory_order_relaxed);
+}
+
+/*
+ * Sizes the OpenMP team of the core generators for the duration of one generator
+ * call. Calls made from a batch task or from inside an OpenMP parallel region stay
+ * on their thread, as the threads around them already occupy the cores. Otherwise
+ * the thread budget is divided among all generator calls in flight, so callers that
+ * generate from their own thread pools are not oversubscribed.
+ */
+class GeneratorThreads {
+
+public:
+    explicit GeneratorThreads(size_t pixelCount) {
+        int active = activeGenerators.fetch_add(1, std::memory_order_relaxed) + 1;
+#ifdef MSDFGEN_USE_OPENMP
+        int threads = 1;
+        if (pixelCount >= MSDFGEN_C_PARALLEL_GENERATION_PIXELS && !ThreadPool::insideTask() && !omp_in_parallel()) {
+            int budget = resolveThreadCount(0);
+            threads = std::max(1, (budget > 0 ? budget : ThreadPool::hardwareThreads()) / active);
+        }
+        // The team size is a per-thread OpenMP setting of the caller, so it is restored afterwards
+        previousThreads = omp_get_max_threads();
+        omp_set_num_threads(threads);
+#else
+        (void) pixelCount, (void) active;
+#endif
+    }
+
+    ~GeneratorThreads() {
+#ifdef MSDFGEN_USE_OPENMP
+        omp_set_num_threads(previousThreads);
+#endif
+        activeGenerators.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    GeneratorThreads(const GeneratorThreads&) = delete;
+    GeneratorThreads& operator=(const GeneratorThreads&) = delete;
+
+private:
+#ifdef MSDFGEN_USE_OPENMP
+    int previousThreads;
+#endif
+
+};
+
+/* Error correction modes that work on the field alone, without distance checks against the shape */
+static bool shapelessCorrection(MsdfgenErrorCorrectionMode mode) {
+    return mode == MSDFGEN_ERROR_CORRECTION_FAST_DISTANCE || mode == MSDFGEN_ERROR_CORRECTION_FAST_EDGE || mode == MSDFGEN_ERROR_CORRECTION_LEGACY;
+}
+
+/* Per-axis clash threshold of the legacy pass: ratio pixels of distance, in field values */
+static Vector2 legacyThreshold(const SDFTransformation& transformation, double ratio) {
+    double unit = transformation.distanceMapping(1.0) - transformation.distanceMapping(0.0);
+    Vector2 pixel = transformation.unprojectVector(Vector2(1.0, 1.0));
+    return Vector2(ratio * unit * pixel.x, ratio * unit * pixel.y);
+}
+
+/*
+ * Runs the MSDF error correction selected by config. The exact modes run msdfgen's
+ * error correction the way generateMSDF and generateMTSDF do after computing
+ * distances, through a per-thread stencil that is inspected afterwards to count
+ * the corrected texels. The fast and legacy modes only look at the field itself,
+ * so shape may be null for them; with counters enabled, their corrected texels
+ * are counted by comparing the field with a copy.
+ */
+template <int N>
+static void correctErrors(const BitmapRef<float, N>& sdf, const Shape* shape, const SDFTransformation& transformation, const MsdfgenGeneratorConfig& config) {
+    const MsdfgenErrorCorrectionConfig& errorCorrection = config.errorCorrection;
+    if (errorCorrection.mode == MSDFGEN_ERROR_CORRECTION_DISABLED) return;
+    StageTimer timer(MSDFGEN_STAGE_ERROR_CORRECTION);
+    size_t valueCount = static_cast<size_t>(sdf.width) * sdf.height * N;
+
+    if (shapelessCorrection(errorCorrection.mode)) {
+        static thread_local std::vector<float> original;
+        bool counting = statsActive();
+        if (counting) {
+            original.assign(sdf.pixels, sdf.pixels + valueCount);
+        }
+        switch (errorCorrection.mode) {
+            case MSDFGEN_ERROR_CORRECTION_FAST_DISTANCE:
+                msdfFastDistanceErrorCorrection(sdf, transformation, errorCorrection.minDeviationRatio);
+                break;
+            case MSDFGEN_ERROR_CORRECTION_FAST_EDGE:
+                msdfFastEdgeErrorCorrection(sdf, transformation, errorCorrection.minDeviationRatio);
+                break;
+            default:
+                msdfErrorCorrection_legacy(sdf, legacyThreshold(transformation, errorCorrection.minDeviationRatio));
+                break;
+        }
+        if (counting) {
+            size_t corrected = 0;
+            for (size_t i = 0; i < valueCount; i += N) {
+                corrected += !std::equal(sdf.pixels + i, sdf.pixels + i + N, original.data() + i);
+            }
+            msdfgen_c::addStat(threadStats().correctedPixels, corrected);
+        }
+        return;
+    }
+
+    if (!shape) return;
+    static thread_local std::vector<byte> stencil;
+    stencil.resize(static_cast<size_t>(sdf.width) * sdf.height);
+    MSDFGeneratorConfig msdfConfig = toMSDFGeneratorConfig(&config);
+    msdfConfig.errorCorrection.buffer = stencil.data();
+    msdfErrorCorrection(sdf, *shape, transformation, msdfConfig);
+    if (statsActive()) {
+        size_t corrected = std::count_if(stencil.begin(), stencil.end(), [](byte flags) {
+            return (flags & MSDFErrorCorrection::ERROR) != 0;
+        });
+        msdfgen_c::addStat(threadStats().correctedPixels, corrected);
+    }
+}
+
+/* Runs the generator for type on a tightly packed buffer of width x height pixels */
+static void generatePacked(
+    float* pixels,
+    MsdfgenBitmapType type,
+    const Shape& shape,
+    int width, int height,
+    const SDFTransformation& transformation,
+    const MsdfgenGeneratorConfig& config
+) {
+    GeneratorThreads threads(static_cast<size_t>(width) * height);
+    unsigned long long edgeEvaluations = 0;
+    int sign = scanlineSign.load(std::memory_order_relaxed);
+    {
+        // The MSDF generators are run without error correction, which follows as a separate stage with the same result
+        StageTimer timer(MSDFGEN_STAGE_DISTANCE);
+        MsdfgenGeneratorConfig generation = distanceStageConfig(config, sign);
+        bool overlapSupport = generation.overlapSupport != 0;
+        MSDFGeneratorConfig distanceConfig(overlapSupport, ErrorCorrectionConfig(ErrorCorrectionConfig::DISABLED));
+        switch (type) {
+            case MSDFGEN_BITMAP_SDF:
+                if (useBandCulling(type, shape, generation)) {
+                    bool accelerated = !overlapSupport && useEdgeBvh(shape);
+                    edgeEvaluations = msdfgen_c::generateSDFBanded(BitmapRef<float, 1>(pixels, width, height), shape, transformation, overlapSupport, accelerated);
+                    break;
                 }
+                if (!overlapSupport && useEdgeBvh(shape)) {
+                    edgeEvaluations = msdfgen_c::generateSDFAccelerated(BitmapRef<float, 1>(pixels, width, height), shape, transformation);
+                    break;
+                }
+                if (useSinglePrecision(type, shape, generation)) {
+                    BitmapRef<float, 1> output(pixels, width, height);
+                    edgeEvaluations = overlapSupport || msdfgen_c::distancePacketWidth()
+                        ? msdfgen_c::generateSDFPackets(output, shape, transformation, overlapSupport)
+                        : msdfgen_c::generateSDFFlat<float>(output, shape, transformation);
+                    break;
+                }
+                generateSDF(BitmapRef<float, 1>(pixels, width, height), shape, transformation, GeneratorConfig(overlapSupport));
+                break;
+            case MSDFGEN_BITMAP_PSDF:
+                generatePSDF(BitmapRef<float, 1>(pixels, width, height), shape, transformation, GeneratorConfig(overlapSupport));
+                break;
+            case MSDFGEN_BITMAP_MSDF:
+                if (useSinglePrecision(type, shape, generation)) {
+                    edgeEvaluations = msdfgen_c::generateMSDFPackets(BitmapRef<float, 3>(pixels, width, height), shape, transformation, overlapSupport);
+                    break;
+                }
+                generateMSDF(BitmapRef<float, 3>(pixels, width, height), shape, transformation, distanceConfig);
+                break;
+            case MSDFGEN_BITMAP_MTSDF:
+                if (useSinglePrecision(type, shape, generation)) {
+                    edgeEvaluations = msdfgen_c::generateMTSDFPackets(BitmapRef<float, 4>(pixels, width, height), shape, transformation, overlapSupport);
+                    break;
+                }
+                generateMTSDF(BitmapRef<float, 4>(pixels, width, height), shape, transformation, distanceConfig);
+                break;
+        }
+
+        if (sign) {
+            FillRule fillRule = toFillRule(static_cast<MsdfgenFillRule>(sign - 1));
+            switch (type) {
+                case MSDFGEN_BITMAP_SDF:
+                case MSDFGEN_BITMAP_PSDF:
+                    msdfgen_c::applyFillSign(BitmapRef<float, 1>(pixels, width, height), shape, transformation, fillRule);
+                    break;
+                case MSDFGEN_BITMAP_MSDF:
+                    msdfgen_c::applyFillSign(BitmapRef<float, 3>(pixels, width, height), shape, transformation, fillRule);
+                    break;
+                case MSDFGEN_BITMAP_MTSDF:
+                    msdfgen_c::applyFillSign(BitmapRef<float, 4>(pixels, width, height), shape, transformation, fillRule);
+                    break;
+            }
+        }
+    }
+    MsdfgenGeneratorConfig correction = correctionStageConfig(config, sign);
+    if (type == MSDFGEN_BITMAP_MSDF) {
+        correctErrors(BitmapRef<float, 3>(pixels, width, height), &shape, transformation, correction);
+    } else if (type == MSDFGEN_BITMAP_MTSDF) {
+        correctErrors(BitmapRef<float, 4>(pixels, width, height), &shape, transformation, correction);
+    }
+
+    if (statsActive()) {
+        msdfgen_c::StatCounters& counters = threadStats();
+        unsigned long long pixelCount = static_cast<unsigned long long>(width) * height;
+        msdfgen_c::addStat(counters.pixelsGenerated, pixelCount);
+        msdfgen_c::addStat(counters.edgeEvaluations, edgeEvaluations ? edgeEvaluations : pixelCount * shape.edgeCount());
+    }
+}
+
+/* Number of points consumed by a path verb, -1 for invalid verbs */
+static int verbPointCount(unsigned char verb) {
+    switch (verb) {
+        case MSDFGEN_VERB_MOVE:
+        case MSDFGEN_VERB_LINE: return 1;
+        case MSDFGEN_VERB_QUADRATIC: return 2;
+        case MSDFGEN_VERB_CUBIC: return 3;
+        case MSDFGEN_VERB_CLOSE: return 0;
+    }
+    return -1;
+}
+
+/*
+ * Walks a verb/point path, calling beginContour() before the first edge of every
+ * contour and addEdge(points, pointCount) for every edge, including the line that
+ * closes a contour whose last point differs from its start. Contours without edges
+ * are skipped. Returns false for malformed paths.
+ */
+template <typename BeginContour, typename AddEdge>
+static bool walkPath(const unsigned char* verbs, int verbCount, const double* points, int pointCount, BeginContour beginContour, AddEdge addEdge) {
+    int next = 0;
+    bool inContour = false, hasEdges = false;
+    Point2 start, current;
+    auto closeContour = [&]() {
+        if (hasEdges && current != start) {
+            Point2 line[2] = {current, start};
+            addEdge(line, 2);
+        }
+        inContour = false;
+        hasEdges = false;
+    };
+
+    for (int i = 0; i < verbCount; i++) {
+        int count = verbPointCount(verbs[i]);
+        if (count < 0 || count > pointCount - next) return false;
+        if (verbs[i] == MSDFGEN_VERB_MOVE) {
+            closeContour();
+            inContour = true;
+            start = current = Point2(points[2 * next], points[2 * next + 1]);
+        } else if (verbs[i] == MSDFGEN_VERB_CLOSE) {
+            closeContour();
+        } else {
+            if (!inContour) return false;
+            if (!hasEdges) {
+                beginContour();
+                hasEdges = true;
+            }
+            Point2 edge[4] = {current};
+            for (int j = 0; j < count; j++) {
+                edge[j + 1] = Point2(points[2 * (next + j)], points[2 * (next + j) + 1]);
+            }
+            addEdge(edge, count + 1);
+            current = edge[count];
+        }
+        next += count;
+    }
+    closeContour();
+    return next == pointCount;
+}
+
+static void hashShape(Hasher& hasher, const Shape& shape) {
+    hasher.add(shape.getYAxisOrientation() == Y_DOWNWARD ? 1 : 0);
+    hasher.add(static_cast<int>(shape.contours.size()));
+    for (const Contour& contour : shape.contours) {
+        hasher.add(static_cast<int>(contour.edges.size()));
+        for (const EdgeHolder& edge : contour.edges) {
+            const EdgeSegment* segment = edge;
+            int pointCount;
+            const Point2* points = segmentPoints(segment, pointCount);
+            hasher.add(static_cast<int>(segment->color) << 4 | pointCount);
+            for (int i = 0; i < pointCount; i++) {
+                hasher.add(points[i].x);
+                hasher.add(points[i].y);
+            }
+        }
+    }
+}
+
+/* Identifies a generation result by everything that affects its pixels */
+static CacheKey generationKey(
+    MsdfgenBitmapType type,
+    MsdfgenPixelFormat format,
+    const Shape& shape,
+    int width, int height,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig& config
+) {
+    Hasher hasher;
+    hasher.add(MSDFGEN_C_GENERATOR_REVISION);
+    for (const char* c = MSDFGEN_C_MSDFGEN_VERSION; *c; c++) {
+        hasher.add(static_cast<int>(*c));
+    }
+    hasher.add(static_cast<int>(type));
+    hasher.add(static_cast<int>(format));
+    hasher.add(width);
+    hasher.add(height);
+    hasher.add(scaleX);
+    hasher.add(scaleY);
+    hasher.add(translateX);
+    hasher.add(translateY);
+    hasher.add(rangePixels);
+    hasher.add(config.overlapSupport != 0 ? 1 : 0);
+    int sign = scanlineSign.load(std::memory_order_relaxed);
+    if (sign) {
+        hasher.add(sign);
+    }
+    if (type == MSDFGEN_BITMAP_MSDF || type == MSDFGEN_BITMAP_MTSDF) {
+        hasher.add(static_cast<int>(config.errorCorrection.mode));
+        hasher.add(static_cast<int>(config.errorCorrection.distanceCheckMode));
+        hasher.add(config.errorCorrection.minDeviationRatio);
+        hasher.add(config.errorCorrection.minImproveRatio);
+    }
+    MsdfgenGeneratorConfig generation = distanceStageConfig(config, sign);
+    if (useSinglePrecision(type, shape, generation)) {
+        hasher.add(static_cast<int>(MSDFGEN_PRECISION_FLOAT));
+    }
+    // Band culling clamps the values beyond the range, which integer formats do anyway
+    if (useBandCulling(type, shape, generation) && (format == MSDFGEN_PIXEL_FLOAT32 || format == MSDFGEN_PIXEL_FLOAT16)) {
+        hasher.add(static_cast<int>(MSDFGEN_PRECISION_DOUBLE));
+        hasher.add(static_cast<int>(MSDFGEN_BAND_CULLING_ENABLED));
+    }
+    hashShape(hasher, shape);
+    return hasher.key();
+}
+
+static void copyRows(void* dst, ptrdiff_t dstStride, const void* src, ptrdiff_t srcStride, size_t rowBytes, int rows) {
+    for (int y = 0; y < rows; y++) {
+        memcpy(static_cast<unsigned char*>(dst) + y * dstStride, static_cast<const unsigned char*>(src) + y * srcStride, rowBytes);
+    }
+}
+
+/* Stores rows of packedStride bytes, repacking them first if they are further apart */
+template <class Cache>
+static void storePacked(Cache& cache, const CacheKey& key, const void* pixels, ptrdiff_t stride, size_t packedStride, int height) {
+    if (stride == static_cast<ptrdiff_t>(packedStride)) {
+        cache.store(key, pixels, packedStride * height);
+    } else {
+        std::vector<unsigned char> packed(packedStride * height);
+        copyRows(packed.data(), packedStride, pixels, stride, packedStride, height);
+        cache.store(key, packed.data(), packed.size());
+    }
+}
+
+static std::mutex diskCacheMutex;
+static std::shared_ptr<DiskCache> diskCache;
+
+static std::shared_ptr<DiskCache> activeDiskCache() {
+    std::lock_guard<std::mutex> lock(diskCacheMutex);
+    return diskCache;
+}
+
+/*
+ * Generates the regionWidth x regionHeight pixels at regionX, regionY of a
+ * fieldWidth x fieldHeight field in horizontal strips through a per-thread float
+ * buffer, storing each strip in the target format while it is still in cache.
+ * Region rows are counted in memory order, like the rows of the full bitmap, and
+ * rowStride may be negative to store them in reverse, from the end of a buffer.
+ * With error correction, which compares every texel with its neighbors, or the
+ * scanline sign, whose pixels at zero distance follow their neighbors, strips are
+ * generated with an extra pixel on every side that lies inside the field, so that
+ * the stored pixels see the same neighborhood as in a single full-size pass.
+ */
+static void generateStrips(
+    void* pixels,
+    ptrdiff_t rowStride,
+    MsdfgenPixelFormat format,
+    MsdfgenBitmapType type,
+    const Shape& shape,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    int regionWidth, int regionHeight,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig& config
+) {
+    bool errorCorrection = (type == MSDFGEN_BITMAP_MSDF || type == MSDFGEN_BITMAP_MTSDF) && config.errorCorrection.mode != MSDFGEN_ERROR_CORRECTION_DISABLED;
+    bool fillSign = scanlineSign.load(std::memory_order_relaxed) != 0;
+    int apron = errorCorrection || fillSign ? 1 : 0;
+    int left = std::max(0, regionX - apron);
+    int right = std::min(fieldWidth, regionX + regionWidth + apron);
+    int stripWidth = right - left;
+    int stripRows = std::max(1, MSDFGEN_C_STRIP_PIXELS / stripWidth);
+    bool yDownward = shape.getYAxisOrientation() == Y_DOWNWARD;
+    int channels = bitmapChannels(type);
+    size_t stripRowValues = static_cast<size_t>(stripWidth) * channels;
+    size_t regionRowValues = static_cast<size_t>(regionWidth) * channels;
+    size_t columnOffset = static_cast<size_t>(regionX - left) * channels;
+
+    static thread_local std::vector<float> scratch;
+    for (int firstRow = regionY; firstRow < regionY + regionHeight; firstRow += stripRows) {
+        int rows = std::min(stripRows, regionY + regionHeight - firstRow);
+        int begin = std::max(0, firstRow - apron);
+        int end = std::min(fieldHeight, firstRow + rows + apron);
+
+        // Shift the frame so that the strip's pixel centers coincide with those of the full field
+        int offsetY = yDownward ? fieldHeight - end : begin;
+        SDFTransformation transformation = toSDFTransformation(scaleX, scaleY, translateX - left / scaleX, translateY - offsetY / scaleY, rangePixels);
+        scratch.resize(static_cast<size_t>(end - begin) * stripRowValues);
+        generatePacked(scratch.data(), type, shape, stripWidth, end - begin, transformation, config);
+
+        StageTimer timer(MSDFGEN_STAGE_CONVERSION);
+        for (int y = firstRow; y < firstRow + rows; y++) {
+            storeValues(static_cast<unsigned char*>(pixels) + (y - regionY) * rowStride, format, scratch.data() + (y - begin) * stripRowValues + columnOffset, regionRowValues);
+        }
+    }
+}
+
+/* Byte stride of rows of width pixels, or 0 if rowStride is invalid for format */
+static size_t validRowStride(int rowStride, int width, int channels, size_t valueSize) {
+    size_t packedStride = static_cast<size_t>(width) * channels * valueSize;
+    if (rowStride < 0 || (rowStride > 0 && (static_cast<size_t>(rowStride) < packedStride || rowStride % valueSize))) return 0;
+    return rowStride > 0 ? static_cast<size_t>(rowStride) : packedStride;
+}
+
+/*
+ * Generates into caller-owned rows stride bytes apart, consulting the memory and disk
+ * caches if enabled. Tightly packed float output in memory order is written in place;
+ * other strides, including negative ones, and formats are produced strip by strip.
+ */
+static int generateRows(
+    void* pixels,
+    ptrdiff_t stride,
+    MsdfgenPixelFormat format,
+    MsdfgenBitmapType type,
+    const Shape* shape,
+    int width, int height,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig& config
+) {
+    size_t packedStride = static_cast<size_t>(width) * bitmapChannels(type) * pixelFormatSize(format);
+
+    // The memory cache is consulted first; disk hits are promoted into it
+    MemoryCache& memoryCache = MemoryCache::instance();
+    bool memory = memoryCache.enabled();
+    std::shared_ptr<DiskCache> cache = activeDiskCache();
+    CacheKey key = {0, 0};
+    size_t byteSize = packedStride * height;
+    if (memory || cache) {
+        key = generationKey(type, format, *shape, width, height, scaleX, scaleY, translateX, translateY, rangePixels, config);
+        auto consume = [&](const unsigned char* data) {
+            copyRows(pixels, stride, data, packedStride, packedStride, height);
+        };
+        if (memory && memoryCache.load(key, byteSize, consume)) return 1;
+        if (cache && cache->load(key, byteSize, consume)) {
+            if (memory) {
+                storePacked(memoryCache, key, pixels, stride, packedStride, height);
             }
+            return 1;
         }
-        result.width = width;
-        result.height = height;
-        result.channels = N;
-        result.success = 1;
     }
+
+    if (format == MSDFGEN_PIXEL_FLOAT32 && stride == static_cast<ptrdiff_t>(packedStride)) {
+        SDFTransformation transformation = toSDFTransformation(scaleX, scaleY, translateX, translateY, rangePixels);
+        generatePacked(static_cast<float*>(pixels), type, *shape, width, height, transformation, config);
+    } else {
+        generateStrips(pixels, stride, format, type, *shape, width, height, 0, 0, width, height, scaleX, scaleY, translateX, translateY, rangePixels, config);
+    }
+
+    if (memory) {
+        storePacked(memoryCache, key, pixels, stride, packedStride, height);
+    }
+    if (cache) {
+        storePacked(*cache, key, pixels, stride, packedStride, height);
+    }
+    return 1;
+}
+
+/* Generates into caller-owned storage with rowStride bytes per row, 0 for tightly packed rows */
+static int generateInto(
+    void* pixels,
+    MsdfgenPixelFormat format,
+    MsdfgenBitmapType type,
+    MsdfgenShape handle,
+    int width, int height,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig& config
+) {
+    int channels = bitmapChannels(type);
+    size_t valueSize = pixelFormatSize(format);
+    if (!handle || !pixels || width <= 0 || height <= 0 || !channels || !valueSize) return 0;
+    size_t stride = validRowStride(rowStride, width, channels, valueSize);
+    if (!stride) return 0;
+    return generateRows(pixels, static_cast<ptrdiff_t>(stride), format, type, static_cast<const Shape*>(handle), width, height, scaleX, scaleY, translateX, translateY, rangePixels, config);
+}
+
+static bool validRegion(int fieldWidth, int fieldHeight, int regionX, int regionY, int regionWidth, int regionHeight) {
+    if (fieldWidth <= 0 || fieldHeight <= 0 || regionX < 0 || regionY < 0 || regionWidth <= 0 || regionHeight <= 0) return false;
+    return regionWidth <= fieldWidth - regionX && regionHeight <= fieldHeight - regionY;
+}
+
+/*
+ * Generates a region of a larger field into caller-owned rows stride bytes apart. A
+ * region that covers the whole field is an ordinary generation and may use the result
+ * caches; smaller regions are always generated.
+ */
+static int generateRegionRows(
+    void* pixels,
+    ptrdiff_t stride,
+    MsdfgenPixelFormat format,
+    MsdfgenBitmapType type,
+    const Shape* shape,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    int regionWidth, int regionHeight,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig& config
+) {
+    if (regionWidth == fieldWidth && regionHeight == fieldHeight) {
+        return generateRows(pixels, stride, format, type, shape, fieldWidth, fieldHeight, scaleX, scaleY, translateX, translateY, rangePixels, config);
+    }
+    generateStrips(pixels, stride, format, type, *shape, fieldWidth, fieldHeight, regionX, regionY, regionWidth, regionHeight, scaleX, scaleY, translateX, translateY, rangePixels, config);
+    return 1;
+}
+
+static int generateRegion(
+    void* pixels,
+    MsdfgenPixelFormat format,
+    MsdfgenBitmapType type,
+    MsdfgenShape handle,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    int regionWidth, int regionHeight,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig& config
+) {
+    int channels = bitmapChannels(type);
+    size_t valueSize = pixelFormatSize(format);
+    if (!handle || !pixels || !channels || !valueSize) return 0;
+    if (!validRegion(fieldWidth, fieldHeight, regionX, regionY, regionWidth, regionHeight)) return 0;
+    size_t stride = validRowStride(rowStride, regionWidth, channels, valueSize);
+    if (!stride) return 0;
+    return generateRegionRows(pixels, static_cast<ptrdiff_t>(stride), format, type, static_cast<const Shape*>(handle), fieldWidth, fieldHeight, regionX, regionY, regionWidth, regionHeight, scaleX, scaleY, translateX, translateY, rangePixels, config);
+}
+
+/* Rows of a bitmap view in memory order: the bottom row and the signed distance in bytes to the row above */
+struct ViewRows {
+    unsigned char* bottom;
+    ptrdiff_t stride;
+};
+
+/* Resolves a view whose values are channels wide, or returns false if it is invalid */
+static bool resolveView(const MsdfgenBitmapView* view, int channels, ViewRows& rows) {
+    if (!view || !view->pixels || view->width <= 0 || view->height <= 0 || view->channels != channels) return false;
+    size_t valueSize = pixelFormatSize(view->format);
+    if (!valueSize) return false;
+    size_t stride = validRowStride(view->rowStride, view->width, channels, valueSize);
+    if (!stride) return false;
+    rows.bottom = static_cast<unsigned char*>(view->pixels);
+    rows.stride = static_cast<ptrdiff_t>(stride);
+    if (view->yOrientation == MSDFGEN_Y_TOP_DOWN) {
+        rows.bottom += static_cast<ptrdiff_t>(view->height - 1) * rows.stride;
+        rows.stride = -rows.stride;
+    }
+    return true;
+}
+
+/* Generates into a view, whose size is that of the field */
+static int generateView(
+    const MsdfgenBitmapView* view,
+    MsdfgenBitmapType type,
+    MsdfgenShape handle,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig& config
+) {
+    ViewRows rows;
+    if (!handle || !bitmapChannels(type) || !resolveView(view, bitmapChannels(type), rows)) return 0;
+    return generateRows(rows.bottom, rows.stride, view->format, type, static_cast<const Shape*>(handle), view->width, view->height, scaleX, scaleY, translateX, translateY, rangePixels, config);
+}
+
+/* Common implementation of all allocating generator entry points */
+static MsdfgenBitmap generateBitmap(
+    MsdfgenShape handle,
+    MsdfgenBitmapType type,
+    int width, int height,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig& config
+) {
+    MsdfgenBitmap result = {nullptr, 0, 0, 0, 0};
+    int channels = bitmapChannels(type);
+    if (!handle || width <= 0 || height <= 0 || !channels) return result;
+
+    // MsdfgenBitmap has the same row-major layout as BitmapRef, so the field is generated straight into the result
+    size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height) * channels;
+    result.pixels = static_cast<float*>(malloc(pixelCount * sizeof(float)));
+    if (!result.pixels) return result;
+
+    int success = 0;
+    try {
+        success = generateInto(result.pixels, MSDFGEN_PIXEL_FLOAT32, type, handle, width, height, 0, scaleX, scaleY, translateX, translateY, rangePixels, config);
+    } catch (...) {
+        success = 0;
+    }
+    if (!success) {
+        free(result.pixels);
+        result.pixels = nullptr;
+        return result;
+    }
+    result.width = width;
+    result.height = height;
+    result.channels = channels;
+    result.success = 1;
     return result;
 }
 
@@ -92,23 +881,28 @@ static MsdfgenBitmap createBitmapResult(const Bitmap<float, N>& bitmap) {
 extern "C" {
 
 MsdfgenShape msdfgen_shape_create(void) {
-    return new Shape();
+    return static_cast<Shape*>(new PooledShape());
 }
 
 void msdfgen_shape_destroy(MsdfgenShape handle) {
     if (handle) {
-        delete static_cast<Shape*>(handle);
+        delete toPooledShape(handle);
     }
 }
 
+void msdfgen_shape_reset(MsdfgenShape handle) {
+    if (!handle) return;
+    toPooledShape(handle)->reset();
+}
+
 /* ============================================================================
  * Contour and edge operations
  * ============================================================================ */
 
 int msdfgen_shape_add_contour(MsdfgenShape handle) {
     if (!handle) return -1;
-    Shape* shape = static_cast<Shape*>(handle);
-    shape->addContour();
+    PooledShape* shape = toPooledShape(handle);
+    shape->addRecycledContour();
     return static_cast<int>(shape->contours.size() - 1);
 }
 
@@ -119,12 +913,10 @@ void msdfgen_contour_add_linear(
     double x1, double y1
 ) {
     if (!handle) return;
-    Shape* shape = static_cast<Shape*>(handle);
+    PooledShape* shape = toPooledShape(handle);
     if (contourIndex < 0 || contourIndex >= static_cast<int>(shape->contours.size())) return;
 
-    shape->contours[contourIndex].addEdge(EdgeHolder(
-        new LinearSegment(Point2(x0, y0), Point2(x1, y1))
-    ));
+    shape->addLinear(shape->contours[contourIndex], Point2(x0, y0), Point2(x1, y1));
 }
 
 void msdfgen_contour_add_quadratic(
@@ -135,12 +927,10 @@ void msdfgen_contour_add_quadratic(
     double x2, double y2
 ) {
     if (!handle) return;
-    Shape* shape = static_cast<Shape*>(handle);
+    PooledShape* shape = toPooledShape(handle);
     if (contourIndex < 0 || contourIndex >= static_cast<int>(shape->contours.size())) return;
 
-    shape->contours[contourIndex].addEdge(EdgeHolder(
-        new QuadraticSegment(Point2(x0, y0), Point2(x1, y1), Point2(x2, y2))
-    ));
+    shape->addQuadratic(shape->contours[contourIndex], Point2(x0, y0), Point2(x1, y1), Point2(x2, y2));
 }
 
 void msdfgen_contour_add_cubic(
@@ -152,12 +942,97 @@ void msdfgen_contour_add_cubic(
     double x3, double y3
 ) {
     if (!handle) return;
-    Shape* shape = static_cast<Shape*>(handle);
+    PooledShape* shape = toPooledShape(handle);
     if (contourIndex < 0 || contourIndex >= static_cast<int>(shape->contours.size())) return;
 
-    shape->contours[contourIndex].addEdge(EdgeHolder(
-        new CubicSegment(Point2(x0, y0), Point2(x1, y1), Point2(x2, y2), Point2(x3, y3))
-    ));
+    shape->addCubic(shape->contours[contourIndex], Point2(x0, y0), Point2(x1, y1), Point2(x2, y2), Point2(x3, y3));
+}
+
+int msdfgen_shape_build_from_arrays(
+    MsdfgenShape handle,
+    const unsigned char* verbs,
+    int verbCount,
+    const double* points,
+    int pointCount
+) {
+    if (!handle || verbCount < 0 || pointCount < 0) return 0;
+    if ((verbCount > 0 && !verbs) || (pointCount > 0 && !points)) return 0;
+    PooledShape* shape = toPooledShape(handle);
+
+    // Validate the whole path and size every contour before the shape is touched
+    std::vector<int> contourEdges;
+    bool valid = walkPath(verbs, verbCount, points, pointCount,
+        [&]() { contourEdges.push_back(0); },
+        [&](const Point2*, int) { ++contourEdges.back(); }
+    );
+    if (!valid) return 0;
+
+    shape->contours.reserve(shape->contours.size() + contourEdges.size());
+    size_t contourIndex = 0;
+    Contour* contour = nullptr;
+    walkPath(verbs, verbCount, points, pointCount,
+        [&]() {
+            contour = &shape->addRecycledContour();
+            contour->edges.reserve(contourEdges[contourIndex++]);
+        },
+        [&](const Point2* p, int count) {
+            switch (count) {
+                case 2: shape->addLinear(*contour, p[0], p[1]); break;
+                case 3: shape->addQuadratic(*contour, p[0], p[1], p[2]); break;
+                case 4: shape->addCubic(*contour, p[0], p[1], p[2], p[3]); break;
+            }
+        }
+    );
+    return 1;
+}
+
+int msdfgen_shape_export_arrays(
+    MsdfgenShape handle,
+    unsigned char* verbs,
+    int* verbCount,
+    double* points,
+    int* pointCount
+) {
+    if (!handle || !verbCount || !pointCount) return 0;
+    const Shape* shape = static_cast<const Shape*>(handle);
+
+    int requiredVerbs = 0, requiredPoints = 0;
+    for (const Contour& contour : shape->contours) {
+        if (contour.edges.empty()) continue;
+        requiredVerbs += 2 + static_cast<int>(contour.edges.size());
+        requiredPoints += 1;
+        for (const EdgeHolder& edge : contour.edges) {
+            int edgePoints;
+            if (!segmentPoints(edge, edgePoints)) return 0;
+            requiredPoints += edgePoints - 1;
+        }
+    }
+    bool query = !verbs || !points;
+    bool fits = !query && *verbCount >= requiredVerbs && *pointCount >= requiredPoints;
+    *verbCount = requiredVerbs;
+    *pointCount = requiredPoints;
+    if (query) return 1;
+    if (!fits) return 0;
+
+    static const unsigned char edgeVerbs[] = {0, 0, MSDFGEN_VERB_LINE, MSDFGEN_VERB_QUADRATIC, MSDFGEN_VERB_CUBIC};
+    for (const Contour& contour : shape->contours) {
+        if (contour.edges.empty()) continue;
+        int edgePoints;
+        const Point2* first = segmentPoints(contour.edges.front(), edgePoints);
+        *verbs++ = MSDFGEN_VERB_MOVE;
+        *points++ = first[0].x;
+        *points++ = first[0].y;
+        for (const EdgeHolder& edge : contour.edges) {
+            const Point2* p = segmentPoints(edge, edgePoints);
+            *verbs++ = edgeVerbs[edgePoints];
+            for (int i = 1; i < edgePoints; i++) {
+                *points++ = p[i].x;
+                *points++ = p[i].y;
+            }
+        }
+        *verbs++ = MSDFGEN_VERB_CLOSE;
+    }
+    return 1;
 }
 
 /* ============================================================================
@@ -202,225 +1077,865 @@ MsdfgenBounds msdfgen_shape_get_bounds_ex(MsdfgenShape handle, double border, do
     return bounds;
 }
 
-void msdfgen_shape_orient_contours(MsdfgenShape handle) {
-    if (!handle) return;
-    Shape* shape = static_cast<Shape*>(handle);
-    shape->orientContours();
+void msdfgen_shape_orient_contours(MsdfgenShape handle) {
+    if (!handle) return;
+    Shape* shape = static_cast<Shape*>(handle);
+    shape->orientContours();
+}
+
+int msdfgen_shape_edge_count(MsdfgenShape handle) {
+    if (!handle) return 0;
+    Shape* shape = static_cast<Shape*>(handle);
+    return shape->edgeCount();
+}
+
+MsdfgenYAxisOrientation msdfgen_shape_get_y_axis_orientation(MsdfgenShape handle) {
+    if (!handle) return MSDFGEN_Y_BOTTOM_UP;
+    Shape* shape = static_cast<Shape*>(handle);
+    return shape->getYAxisOrientation() == Y_DOWNWARD ? MSDFGEN_Y_TOP_DOWN : MSDFGEN_Y_BOTTOM_UP;
+}
+
+void msdfgen_shape_set_y_axis_orientation(MsdfgenShape handle, MsdfgenYAxisOrientation orientation) {
+    if (!handle) return;
+    Shape* shape = static_cast<Shape*>(handle);
+    shape->setYAxisOrientation(orientation == MSDFGEN_Y_TOP_DOWN ? Y_DOWNWARD : Y_UPWARD);
+}
+
+int msdfgen_shape_contour_count(MsdfgenShape handle) {
+    if (!handle) return 0;
+    Shape* shape = static_cast<Shape*>(handle);
+    return static_cast<int>(shape->contours.size());
+}
+
+/* ============================================================================
+ * Edge coloring
+ * ============================================================================ */
+
+void msdfgen_edge_coloring_simple(MsdfgenShape handle, double angleThreshold, unsigned long long seed) {
+    if (!handle) return;
+    Shape* shape = static_cast<Shape*>(handle);
+    StageTimer timer(MSDFGEN_STAGE_EDGE_COLORING);
+    edgeColoringSimple(*shape, angleThreshold, seed);
+}
+
+void msdfgen_edge_coloring_ink_trap(MsdfgenShape handle, double angleThreshold, unsigned long long seed) {
+    if (!handle) return;
+    Shape* shape = static_cast<Shape*>(handle);
+    StageTimer timer(MSDFGEN_STAGE_EDGE_COLORING);
+    edgeColoringInkTrap(*shape, angleThreshold, seed);
+}
+
+void msdfgen_edge_coloring_by_distance(MsdfgenShape handle, double angleThreshold, unsigned long long seed) {
+    if (!handle) return;
+    Shape* shape = static_cast<Shape*>(handle);
+    StageTimer timer(MSDFGEN_STAGE_EDGE_COLORING);
+    edgeColoringByDistance(*shape, angleThreshold, seed);
+}
+
+/* ============================================================================
+ * Configuration helpers
+ * ============================================================================ */
+
+MsdfgenErrorCorrectionConfig msdfgen_error_correction_config_default(void) {
+    MsdfgenErrorCorrectionConfig config;
+    config.mode = MSDFGEN_ERROR_CORRECTION_EDGE_PRIORITY;
+    config.distanceCheckMode = MSDFGEN_DISTANCE_CHECK_AT_EDGE;
+    // These match msdfgen's default values (10/9 ≈ 1.111...)
+    config.minDeviationRatio = 1.11111111111111111;
+    config.minImproveRatio = 1.11111111111111111;
+    return config;
+}
+
+MsdfgenGeneratorConfig msdfgen_generator_config_default(void) {
+    MsdfgenGeneratorConfig config;
+    config.overlapSupport = 1;
+    config.errorCorrection = msdfgen_error_correction_config_default();
+    return config;
+}
+
+/* ============================================================================
+ * SDF Generation
+ * ============================================================================ */
+
+MsdfgenBitmap msdfgen_generate_sdf(
+    MsdfgenShape handle,
+    int width, int height,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels
+) {
+    return msdfgen_generate_sdf_ex(handle, width, height, scaleX, scaleY, translateX, translateY, rangePixels, 1);
+}
+
+MsdfgenBitmap msdfgen_generate_sdf_ex(
+    MsdfgenShape handle,
+    int width, int height,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    int overlapSupport
+) {
+    MsdfgenGeneratorConfig config = msdfgen_generator_config_default();
+    config.overlapSupport = overlapSupport;
+    return generateBitmap(handle, MSDFGEN_BITMAP_SDF, width, height, scaleX, scaleY, translateX, translateY, rangePixels, config);
+}
+
+MsdfgenBitmap msdfgen_generate_psdf(
+    MsdfgenShape handle,
+    int width, int height,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels
+) {
+    return msdfgen_generate_psdf_ex(handle, width, height, scaleX, scaleY, translateX, translateY, rangePixels, 1);
+}
+
+MsdfgenBitmap msdfgen_generate_psdf_ex(
+    MsdfgenShape handle,
+    int width, int height,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    int overlapSupport
+) {
+    MsdfgenGeneratorConfig config = msdfgen_generator_config_default();
+    config.overlapSupport = overlapSupport;
+    return generateBitmap(handle, MSDFGEN_BITMAP_PSDF, width, height, scaleX, scaleY, translateX, translateY, rangePixels, config);
+}
+
+MsdfgenBitmap msdfgen_generate_msdf(
+    MsdfgenShape handle,
+    int width, int height,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels
+) {
+    return msdfgen_generate_msdf_ex(handle, width, height, scaleX, scaleY, translateX, translateY, rangePixels, nullptr);
+}
+
+MsdfgenBitmap msdfgen_generate_msdf_ex(
+    MsdfgenShape handle,
+    int width, int height,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+) {
+    MsdfgenGeneratorConfig genConfig = config ? *config : msdfgen_generator_config_default();
+    return generateBitmap(handle, MSDFGEN_BITMAP_MSDF, width, height, scaleX, scaleY, translateX, translateY, rangePixels, genConfig);
+}
+
+MsdfgenBitmap msdfgen_generate_mtsdf(
+    MsdfgenShape handle,
+    int width, int height,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels
+) {
+    return msdfgen_generate_mtsdf_ex(handle, width, height, scaleX, scaleY, translateX, translateY, rangePixels, nullptr);
+}
+
+MsdfgenBitmap msdfgen_generate_mtsdf_ex(
+    MsdfgenShape handle,
+    int width, int height,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+) {
+    MsdfgenGeneratorConfig genConfig = config ? *config : msdfgen_generator_config_default();
+    return generateBitmap(handle, MSDFGEN_BITMAP_MTSDF, width, height, scaleX, scaleY, translateX, translateY, rangePixels, genConfig);
+}
+
+int msdfgen_generate_sdf_into(
+    MsdfgenShape handle,
+    float* pixels,
+    int width, int height,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    int overlapSupport
+) {
+    MsdfgenGeneratorConfig config = msdfgen_generator_config_default();
+    config.overlapSupport = overlapSupport;
+    return generateInto(pixels, MSDFGEN_PIXEL_FLOAT32, MSDFGEN_BITMAP_SDF, handle, width, height, rowStride, scaleX, scaleY, translateX, translateY, rangePixels, config);
+}
+
+int msdfgen_generate_psdf_into(
+    MsdfgenShape handle,
+    float* pixels,
+    int width, int height,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    int overlapSupport
+) {
+    MsdfgenGeneratorConfig config = msdfgen_generator_config_default();
+    config.overlapSupport = overlapSupport;
+    return generateInto(pixels, MSDFGEN_PIXEL_FLOAT32, MSDFGEN_BITMAP_PSDF, handle, width, height, rowStride, scaleX, scaleY, translateX, translateY, rangePixels, config);
+}
+
+int msdfgen_generate_msdf_into(
+    MsdfgenShape handle,
+    float* pixels,
+    int width, int height,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+) {
+    MsdfgenGeneratorConfig genConfig = config ? *config : msdfgen_generator_config_default();
+    return generateInto(pixels, MSDFGEN_PIXEL_FLOAT32, MSDFGEN_BITMAP_MSDF, handle, width, height, rowStride, scaleX, scaleY, translateX, translateY, rangePixels, genConfig);
+}
+
+int msdfgen_generate_mtsdf_into(
+    MsdfgenShape handle,
+    float* pixels,
+    int width, int height,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+) {
+    MsdfgenGeneratorConfig genConfig = config ? *config : msdfgen_generator_config_default();
+    return generateInto(pixels, MSDFGEN_PIXEL_FLOAT32, MSDFGEN_BITMAP_MTSDF, handle, width, height, rowStride, scaleX, scaleY, translateX, translateY, rangePixels, genConfig);
+}
+
+int msdfgen_generate_into_format(
+    MsdfgenShape handle,
+    MsdfgenBitmapType type,
+    MsdfgenPixelFormat format,
+    void* pixels,
+    int width, int height,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+) {
+    MsdfgenGeneratorConfig genConfig = config ? *config : msdfgen_generator_config_default();
+    return generateInto(pixels, format, type, handle, width, height, rowStride, scaleX, scaleY, translateX, translateY, rangePixels, genConfig);
+}
+
+int msdfgen_generate_view(
+    MsdfgenShape handle,
+    MsdfgenBitmapType type,
+    const MsdfgenBitmapView* view,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+) {
+    MsdfgenGeneratorConfig genConfig = config ? *config : msdfgen_generator_config_default();
+    return generateView(view, type, handle, scaleX, scaleY, translateX, translateY, rangePixels, genConfig);
+}
+
+int msdfgen_pixel_format_size(MsdfgenPixelFormat format) {
+    return static_cast<int>(pixelFormatSize(format));
+}
+
+/* ============================================================================
+ * Region generation
+ * ============================================================================ */
+
+int msdfgen_generate_sdf_region(
+    MsdfgenShape handle,
+    float* pixels,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    int regionWidth, int regionHeight,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    int overlapSupport
+) {
+    MsdfgenGeneratorConfig config = msdfgen_generator_config_default();
+    config.overlapSupport = overlapSupport;
+    return generateRegion(pixels, MSDFGEN_PIXEL_FLOAT32, MSDFGEN_BITMAP_SDF, handle, fieldWidth, fieldHeight, regionX, regionY, regionWidth, regionHeight, rowStride, scaleX, scaleY, translateX, translateY, rangePixels, config);
+}
+
+int msdfgen_generate_psdf_region(
+    MsdfgenShape handle,
+    float* pixels,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    int regionWidth, int regionHeight,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    int overlapSupport
+) {
+    MsdfgenGeneratorConfig config = msdfgen_generator_config_default();
+    config.overlapSupport = overlapSupport;
+    return generateRegion(pixels, MSDFGEN_PIXEL_FLOAT32, MSDFGEN_BITMAP_PSDF, handle, fieldWidth, fieldHeight, regionX, regionY, regionWidth, regionHeight, rowStride, scaleX, scaleY, translateX, translateY, rangePixels, config);
+}
+
+int msdfgen_generate_msdf_region(
+    MsdfgenShape handle,
+    float* pixels,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    int regionWidth, int regionHeight,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+) {
+    MsdfgenGeneratorConfig genConfig = config ? *config : msdfgen_generator_config_default();
+    return generateRegion(pixels, MSDFGEN_PIXEL_FLOAT32, MSDFGEN_BITMAP_MSDF, handle, fieldWidth, fieldHeight, regionX, regionY, regionWidth, regionHeight, rowStride, scaleX, scaleY, translateX, translateY, rangePixels, genConfig);
+}
+
+int msdfgen_generate_mtsdf_region(
+    MsdfgenShape handle,
+    float* pixels,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    int regionWidth, int regionHeight,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+) {
+    MsdfgenGeneratorConfig genConfig = config ? *config : msdfgen_generator_config_default();
+    return generateRegion(pixels, MSDFGEN_PIXEL_FLOAT32, MSDFGEN_BITMAP_MTSDF, handle, fieldWidth, fieldHeight, regionX, regionY, regionWidth, regionHeight, rowStride, scaleX, scaleY, translateX, translateY, rangePixels, genConfig);
+}
+
+int msdfgen_generate_region_into_format(
+    MsdfgenShape handle,
+    MsdfgenBitmapType type,
+    MsdfgenPixelFormat format,
+    void* pixels,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    int regionWidth, int regionHeight,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+) {
+    MsdfgenGeneratorConfig genConfig = config ? *config : msdfgen_generator_config_default();
+    return generateRegion(pixels, format, type, handle, fieldWidth, fieldHeight, regionX, regionY, regionWidth, regionHeight, rowStride, scaleX, scaleY, translateX, translateY, rangePixels, genConfig);
+}
+
+int msdfgen_generate_region_view(
+    MsdfgenShape handle,
+    MsdfgenBitmapType type,
+    const MsdfgenBitmapView* view,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+) {
+    ViewRows rows;
+    if (!handle || !bitmapChannels(type) || !resolveView(view, bitmapChannels(type), rows)) return 0;
+    if (!validRegion(fieldWidth, fieldHeight, regionX, regionY, view->width, view->height)) return 0;
+    // Regions are generated in memory order, in which a top-down view's rows count from the bottom
+    if (view->yOrientation == MSDFGEN_Y_TOP_DOWN) {
+        regionY = fieldHeight - regionY - view->height;
+    }
+    MsdfgenGeneratorConfig genConfig = config ? *config : msdfgen_generator_config_default();
+    return generateRegionRows(rows.bottom, rows.stride, view->format, type, static_cast<const Shape*>(handle), fieldWidth, fieldHeight, regionX, regionY, view->width, view->height, scaleX, scaleY, translateX, translateY, rangePixels, genConfig);
+}
+
+/* ============================================================================
+ * Error correction
+ * ============================================================================ */
+
+int msdfgen_error_correction(
+    MsdfgenBitmap* bitmap,
+    MsdfgenShape handle,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+) {
+    if (!bitmap || !bitmap->pixels || bitmap->width <= 0 || bitmap->height <= 0) return 0;
+    MsdfgenGeneratorConfig genConfig = config ? *config : msdfgen_generator_config_default();
+    if (!handle && genConfig.errorCorrection.mode != MSDFGEN_ERROR_CORRECTION_DISABLED && !shapelessCorrection(genConfig.errorCorrection.mode)) return 0;
+    const Shape* shape = static_cast<const Shape*>(handle);
+    SDFTransformation transformation = toSDFTransformation(scaleX, scaleY, translateX, translateY, rangePixels);
+    GeneratorThreads threads(static_cast<size_t>(bitmap->width) * bitmap->height);
+    try {
+        switch (bitmap->channels) {
+            case 3:
+                correctErrors(BitmapRef<float, 3>(bitmap->pixels, bitmap->width, bitmap->height), shape, transformation, genConfig);
+                return 1;
+            case 4:
+                correctErrors(BitmapRef<float, 4>(bitmap->pixels, bitmap->width, bitmap->height), shape, transformation, genConfig);
+                return 1;
+        }
+    } catch (...) { }
+    return 0;
+}
+
+/* ============================================================================
+ * Batch generation
+ * ============================================================================ */
+
+int msdfgen_generate_batch(
+    const MsdfgenBatchItem* items,
+    int count,
+    MsdfgenBitmap* results,
+    int threadCount
+) {
+    if (!items || !results || count <= 0) return 0;
+
+    // Estimated cost is edge count times pixel count, so the largest glyphs are started first
+    std::vector<double> costs(count);
+    for (int i = 0; i < count; i++) {
+        const MsdfgenBatchItem& item = items[i];
+        results[i] = MsdfgenBitmap{nullptr, 0, 0, 0, 0};
+        costs[i] = item.shape ? static_cast<double>(msdfgen_shape_edge_count(item.shape)) * item.width * item.height : 0.0;
+    }
+
+    std::atomic<int> succeeded(0);
+    ThreadPool::instance().parallelFor(count, costs.data(), resolveThreadCount(threadCount), [&](int i) {
+        const MsdfgenBatchItem& item = items[i];
+        try {
+            results[i] = generateBitmap(item.shape, item.type, item.width, item.height,
+                item.scaleX, item.scaleY, item.translateX, item.translateY, item.rangePixels, item.config);
+        } catch (...) {
+            results[i] = MsdfgenBitmap{nullptr, 0, 0, 0, 0};
+        }
+        if (results[i].success) {
+            ++succeeded;
+        }
+    });
+    return succeeded.load();
+}
+
+int msdfgen_generate_batch_into(
+    const MsdfgenBatchItem* items,
+    int count,
+    MsdfgenPixelFormat format,
+    void* const* outputs,
+    const int* rowStrides,
+    int* results,
+    int threadCount
+) {
+    if (!items || !outputs || count <= 0) return 0;
+
+    std::vector<double> costs(count);
+    for (int i = 0; i < count; i++) {
+        const MsdfgenBatchItem& item = items[i];
+        costs[i] = item.shape ? static_cast<double>(msdfgen_shape_edge_count(item.shape)) * item.width * item.height : 0.0;
+    }
+
+    std::atomic<int> succeeded(0);
+    ThreadPool::instance().parallelFor(count, costs.data(), resolveThreadCount(threadCount), [&](int i) {
+        const MsdfgenBatchItem& item = items[i];
+        int success = 0;
+        try {
+            success = generateInto(outputs[i], format, item.type, item.shape, item.width, item.height, rowStrides ? rowStrides[i] : 0,
+                item.scaleX, item.scaleY, item.translateX, item.translateY, item.rangePixels, item.config);
+        } catch (...) {
+            success = 0;
+        }
+        if (results) {
+            results[i] = success;
+        }
+        if (success) {
+            ++succeeded;
+        }
+    });
+    return succeeded.load();
+}
+
+int msdfgen_generate_batch_view(
+    const MsdfgenBatchItem* items,
+    int count,
+    const MsdfgenBitmapView* views,
+    int* results,
+    int threadCount
+) {
+    if (!items || !views || count <= 0) return 0;
+
+    std::vector<double> costs(count);
+    for (int i = 0; i < count; i++) {
+        const MsdfgenBatchItem& item = items[i];
+        costs[i] = item.shape ? static_cast<double>(msdfgen_shape_edge_count(item.shape)) * item.width * item.height : 0.0;
+    }
+
+    std::atomic<int> succeeded(0);
+    ThreadPool::instance().parallelFor(count, costs.data(), resolveThreadCount(threadCount), [&](int i) {
+        const MsdfgenBatchItem& item = items[i];
+        int success = 0;
+        if (views[i].width == item.width && views[i].height == item.height) {
+            try {
+                success = generateView(&views[i], item.type, item.shape,
+                    item.scaleX, item.scaleY, item.translateX, item.translateY, item.rangePixels, item.config);
+            } catch (...) {
+                success = 0;
+            }
+        }
+        if (results) {
+            results[i] = success;
+        }
+        if (success) {
+            ++succeeded;
+        }
+    });
+    return succeeded.load();
+}
+
+/* ============================================================================
+ * Atlas generation
+ * ============================================================================ */
+
+MsdfgenAtlasConfig msdfgen_atlas_config_default(void) {
+    MsdfgenAtlasConfig config;
+    config.type = MSDFGEN_BITMAP_MTSDF;
+    config.format = MSDFGEN_PIXEL_FLOAT32;
+    config.scale = 32.0;
+    config.rangePixels = 4.0;
+    config.spacing = 1;
+    config.width = 0;
+    config.height = 0;
+    config.generator = msdfgen_generator_config_default();
+    config.threadCount = 0;
+    return config;
+}
+
+MsdfgenAtlas msdfgen_generate_atlas(
+    const MsdfgenShape* shapes,
+    int shapeCount,
+    const MsdfgenAtlasConfig* config
+) {
+    MsdfgenAtlas atlas = {nullptr, 0, 0, 0, MSDFGEN_PIXEL_FLOAT32, nullptr, 0, 0};
+    if (!shapes || shapeCount <= 0 || !config) return atlas;
+    int channels = bitmapChannels(config->type);
+    size_t valueSize = pixelFormatSize(config->format);
+    if (!channels || !valueSize || config->scale <= 0 || config->rangePixels < 0) return atlas;
+
+    double scale = config->scale;
+    double padding = 0.5 * config->rangePixels;
+    std::vector<int> widths(shapeCount, 0), heights(shapeCount, 0), xs(shapeCount, 0), ys(shapeCount, 0);
+    std::vector<double> translateX(shapeCount, 0.0), translateY(shapeCount, 0.0), costs(shapeCount, 0.0);
+    for (int i = 0; i < shapeCount; i++) {
+        if (!shapes[i]) continue;
+        const Shape* shape = static_cast<const Shape*>(shapes[i]);
+        Shape::Bounds bounds = shape->getBounds();
+        if (bounds.l >= bounds.r || bounds.b >= bounds.t) continue;
+
+        // Center the shape in a whole-pixel box
+        widths[i] = static_cast<int>(std::ceil((bounds.r - bounds.l) * scale + 2.0 * padding));
+        heights[i] = static_cast<int>(std::ceil((bounds.t - bounds.b) * scale + 2.0 * padding));
+        translateX[i] = 0.5 * (widths[i] / scale - (bounds.r - bounds.l)) - bounds.l;
+        translateY[i] = 0.5 * (heights[i] / scale - (bounds.t - bounds.b)) - bounds.b;
+        costs[i] = static_cast<double>(shape->edgeCount()) * widths[i] * heights[i];
+    }
+
+    int atlasWidth = config->width;
+    int atlasHeight = config->height;
+    if (!packRectangles(widths.data(), heights.data(), shapeCount, config->spacing, atlasWidth, atlasHeight, xs.data(), ys.data())) {
+        return atlas;
+    }
+
+    atlas.pixels = calloc(static_cast<size_t>(atlasWidth) * atlasHeight * channels, valueSize);
+    atlas.glyphs = static_cast<MsdfgenAtlasGlyph*>(calloc(shapeCount, sizeof(MsdfgenAtlasGlyph)));
+    if (!atlas.pixels || !atlas.glyphs) {
+        msdfgen_atlas_free(&atlas);
+        return atlas;
+    }
+
+    size_t pixelSize = channels * valueSize;
+    int rowStride = atlasWidth * static_cast<int>(pixelSize);
+    std::atomic<bool> failed(false);
+    ThreadPool::instance().parallelFor(shapeCount, costs.data(), resolveThreadCount(config->threadCount), [&](int i) {
+        if (widths[i] <= 0 || heights[i] <= 0) return;
+        unsigned char* origin = static_cast<unsigned char*>(atlas.pixels) + (static_cast<size_t>(ys[i]) * atlasWidth + xs[i]) * pixelSize;
+        try {
+            generateInto(origin, config->format, config->type, shapes[i], widths[i], heights[i], rowStride,
+                scale, scale, translateX[i], translateY[i], config->rangePixels, config->generator);
+        } catch (...) {
+            failed = true;
+        }
+    });
+    if (failed) {
+        msdfgen_atlas_free(&atlas);
+        return atlas;
+    }
+
+    for (int i = 0; i < shapeCount; i++) {
+        MsdfgenAtlasGlyph& glyph = atlas.glyphs[i];
+        glyph.x = xs[i];
+        glyph.y = ys[i];
+        glyph.width = widths[i];
+        glyph.height = heights[i];
+        glyph.planeBounds.left = -translateX[i];
+        glyph.planeBounds.bottom = -translateY[i];
+        glyph.planeBounds.right = widths[i] / scale - translateX[i];
+        glyph.planeBounds.top = heights[i] / scale - translateY[i];
+    }
+    atlas.width = atlasWidth;
+    atlas.height = atlasHeight;
+    atlas.channels = channels;
+    atlas.format = config->format;
+    atlas.glyphCount = shapeCount;
+    atlas.success = 1;
+    return atlas;
+}
+
+void msdfgen_atlas_free(MsdfgenAtlas* atlas) {
+    if (!atlas) return;
+    free(atlas->pixels);
+    free(atlas->glyphs);
+    atlas->pixels = nullptr;
+    atlas->glyphs = nullptr;
+    atlas->width = 0;
+    atlas->height = 0;
+    atlas->channels = 0;
+    atlas->format = MSDFGEN_PIXEL_FLOAT32;
+    atlas->glyphCount = 0;
+    atlas->success = 0;
+}
+
+/* ============================================================================
+ * Asynchronous jobs
+ * ============================================================================ */
+
+static std::atomic<int> jobLimit(256);
+static std::atomic<int> jobThreadSetting(0);
+
+/* Copies the item's shape into the job, so the caller may reuse it immediately */
+static MsdfgenJob submitJob(const MsdfgenBatchItem& item, std::function<bool(const MsdfgenBatchItem&, MsdfgenBitmap&)> generate, MsdfgenJobCallback callback, void* userData) {
+    if (!item.shape) return nullptr;
+    std::shared_ptr<PooledShape> shape = std::make_shared<PooledShape>();
+    static_cast<Shape&>(*shape) = *static_cast<const Shape*>(item.shape);
+    MsdfgenBatchItem copy = item;
+    copy.shape = shape.get();
+
+    int threads = jobThreadSetting.load(std::memory_order_relaxed);
+    Job::Work work = [shape, copy, generate](MsdfgenBitmap& result) {
+        return generate(copy, result);
+    };
+    return JobQueue::instance().submit(std::move(work), callback, userData, jobLimit.load(std::memory_order_relaxed), threads > 0 ? threads : msdfgen_get_thread_count());
+}
+
+void msdfgen_jobs_set_limits(int maxJobs, int threadCount) {
+    jobLimit = std::max(0, maxJobs);
+    jobThreadSetting = std::max(0, threadCount);
+}
+
+MsdfgenJob msdfgen_job_submit(
+    const MsdfgenBatchItem* item,
+    MsdfgenJobCallback callback,
+    void* userData
+) {
+    if (!item) return nullptr;
+    try {
+        return submitJob(*item, [](const MsdfgenBatchItem& item, MsdfgenBitmap& result) {
+            result = generateBitmap(item.shape, item.type, item.width, item.height,
+                item.scaleX, item.scaleY, item.translateX, item.translateY, item.rangePixels, item.config);
+            return result.success != 0;
+        }, callback, userData);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+MsdfgenJob msdfgen_job_submit_into(
+    const MsdfgenBatchItem* item,
+    MsdfgenPixelFormat format,
+    void* output,
+    int rowStride,
+    MsdfgenJobCallback callback,
+    void* userData
+) {
+    if (!item || !output) return nullptr;
+    try {
+        return submitJob(*item, [format, output, rowStride](const MsdfgenBatchItem& item, MsdfgenBitmap&) {
+            return generateInto(output, format, item.type, item.shape, item.width, item.height, rowStride,
+                item.scaleX, item.scaleY, item.translateX, item.translateY, item.rangePixels, item.config) != 0;
+        }, callback, userData);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+MsdfgenJob msdfgen_job_submit_view(
+    const MsdfgenBatchItem* item,
+    const MsdfgenBitmapView* view,
+    MsdfgenJobCallback callback,
+    void* userData
+) {
+    if (!item || !view || view->width != item->width || view->height != item->height) return nullptr;
+    try {
+        MsdfgenBitmapView output = *view;
+        return submitJob(*item, [output](const MsdfgenBatchItem& item, MsdfgenBitmap&) {
+            return generateView(&output, item.type, item.shape,
+                item.scaleX, item.scaleY, item.translateX, item.translateY, item.rangePixels, item.config) != 0;
+        }, callback, userData);
+    } catch (...) {
+        return nullptr;
+    }
 }
 
-int msdfgen_shape_edge_count(MsdfgenShape handle) {
-    if (!handle) return 0;
-    Shape* shape = static_cast<Shape*>(handle);
-    return shape->edgeCount();
+MsdfgenJobStatus msdfgen_job_status(MsdfgenJob job) {
+    if (!job) return MSDFGEN_JOB_FAILED;
+    return static_cast<Job*>(job)->status();
 }
 
-MsdfgenYAxisOrientation msdfgen_shape_get_y_axis_orientation(MsdfgenShape handle) {
-    if (!handle) return MSDFGEN_Y_BOTTOM_UP;
-    Shape* shape = static_cast<Shape*>(handle);
-    return shape->getYAxisOrientation() == Y_DOWNWARD ? MSDFGEN_Y_TOP_DOWN : MSDFGEN_Y_BOTTOM_UP;
+MsdfgenJobStatus msdfgen_job_wait(MsdfgenJob job, int timeoutMilliseconds) {
+    if (!job) return MSDFGEN_JOB_FAILED;
+    return static_cast<Job*>(job)->wait(timeoutMilliseconds);
 }
 
-void msdfgen_shape_set_y_axis_orientation(MsdfgenShape handle, MsdfgenYAxisOrientation orientation) {
-    if (!handle) return;
-    Shape* shape = static_cast<Shape*>(handle);
-    shape->setYAxisOrientation(orientation == MSDFGEN_Y_TOP_DOWN ? Y_DOWNWARD : Y_UPWARD);
+int msdfgen_job_cancel(MsdfgenJob job) {
+    if (!job) return 0;
+    return JobQueue::instance().cancel(*static_cast<Job*>(job)) ? 1 : 0;
 }
 
-int msdfgen_shape_contour_count(MsdfgenShape handle) {
-    if (!handle) return 0;
-    Shape* shape = static_cast<Shape*>(handle);
-    return static_cast<int>(shape->contours.size());
+int msdfgen_job_take_result(MsdfgenJob job, MsdfgenBitmap* result) {
+    if (!job || !result) return 0;
+    return static_cast<Job*>(job)->takeResult(*result) ? 1 : 0;
+}
+
+void msdfgen_job_release(MsdfgenJob job) {
+    if (job) {
+        static_cast<Job*>(job)->release();
+    }
 }
 
 /* ============================================================================
- * Edge coloring
+ * Result caches
  * ============================================================================ */
 
-void msdfgen_edge_coloring_simple(MsdfgenShape handle, double angleThreshold, unsigned long long seed) {
-    if (!handle) return;
-    Shape* shape = static_cast<Shape*>(handle);
-    edgeColoringSimple(*shape, angleThreshold, seed);
+int msdfgen_disk_cache_open(const char* path, unsigned long long maxBytes) {
+    if (!path || maxBytes == 0) return 0;
+    // Files of a build with other msdfgen sources or generators are discarded
+    std::string buildVersion = std::string(MSDFGEN_C_MSDFGEN_VERSION) + " r" + std::to_string(MSDFGEN_C_GENERATOR_REVISION);
+    std::shared_ptr<DiskCache> cache = DiskCache::open(path, maxBytes, buildVersion.c_str());
+    if (!cache) return 0;
+    std::lock_guard<std::mutex> lock(diskCacheMutex);
+    diskCache = cache;
+    return 1;
 }
 
-void msdfgen_edge_coloring_ink_trap(MsdfgenShape handle, double angleThreshold, unsigned long long seed) {
-    if (!handle) return;
-    Shape* shape = static_cast<Shape*>(handle);
-    edgeColoringInkTrap(*shape, angleThreshold, seed);
+void msdfgen_disk_cache_close(void) {
+    std::lock_guard<std::mutex> lock(diskCacheMutex);
+    diskCache.reset();
 }
 
-void msdfgen_edge_coloring_by_distance(MsdfgenShape handle, double angleThreshold, unsigned long long seed) {
-    if (!handle) return;
-    Shape* shape = static_cast<Shape*>(handle);
-    edgeColoringByDistance(*shape, angleThreshold, seed);
+void msdfgen_disk_cache_clear(void) {
+    std::shared_ptr<DiskCache> cache = activeDiskCache();
+    if (cache) {
+        cache->clear();
+    }
 }
 
-/* ============================================================================
- * Configuration helpers
- * ============================================================================ */
+void msdfgen_memory_cache_set_budget(unsigned long long maxBytes) {
+    MemoryCache::instance().setBudget(static_cast<size_t>(std::min<unsigned long long>(maxBytes, SIZE_MAX)));
+}
 
-MsdfgenErrorCorrectionConfig msdfgen_error_correction_config_default(void) {
-    MsdfgenErrorCorrectionConfig config;
-    config.mode = MSDFGEN_ERROR_CORRECTION_EDGE_PRIORITY;
-    config.distanceCheckMode = MSDFGEN_DISTANCE_CHECK_AT_EDGE;
-    // These match msdfgen's default values (10/9 ≈ 1.111...)
-    config.minDeviationRatio = 1.11111111111111111;
-    config.minImproveRatio = 1.11111111111111111;
-    return config;
+void msdfgen_memory_cache_clear(void) {
+    MemoryCache::instance().clear();
 }
 
-MsdfgenGeneratorConfig msdfgen_generator_config_default(void) {
-    MsdfgenGeneratorConfig config;
-    config.overlapSupport = 1;
-    config.errorCorrection = msdfgen_error_correction_config_default();
-    return config;
+int msdfgen_memory_cache_get_stats(MsdfgenMemoryCacheStats* stats) {
+    if (!stats) return 0;
+    uint64_t hits, misses, entries, bytes;
+    MemoryCache::instance().readCounters(hits, misses, entries, bytes);
+    stats->hits = hits;
+    stats->misses = misses;
+    stats->entries = entries;
+    stats->bytes = bytes;
+    return 1;
 }
 
 /* ============================================================================
- * SDF Generation
+ * Distance acceleration
  * ============================================================================ */
 
-MsdfgenBitmap msdfgen_generate_sdf(
-    MsdfgenShape handle,
-    int width, int height,
-    double scaleX, double scaleY,
-    double translateX, double translateY,
-    double rangePixels
-) {
-    return msdfgen_generate_sdf_ex(handle, width, height, scaleX, scaleY, translateX, translateY, rangePixels, 1);
+void msdfgen_set_distance_acceleration(MsdfgenDistanceAcceleration mode) {
+    distanceAcceleration = mode;
 }
 
-MsdfgenBitmap msdfgen_generate_sdf_ex(
-    MsdfgenShape handle,
-    int width, int height,
-    double scaleX, double scaleY,
-    double translateX, double translateY,
-    double rangePixels,
-    int overlapSupport
-) {
-    MsdfgenBitmap result = {nullptr, 0, 0, 0, 0};
-    if (!handle || width <= 0 || height <= 0) return result;
-
-    Shape* shape = static_cast<Shape*>(handle);
-    Bitmap<float, 1> bitmap(width, height);
-
-    Vector2 scale(scaleX, scaleY);
-    Vector2 translate(translateX, translateY);
-    Projection projection(scale, translate);
-    Range range(rangePixels / std::min(scaleX, scaleY));
-    SDFTransformation transformation(projection, range);
+MsdfgenDistanceAcceleration msdfgen_get_distance_acceleration(void) {
+    return static_cast<MsdfgenDistanceAcceleration>(distanceAcceleration.load());
+}
 
-    GeneratorConfig config(overlapSupport != 0);
-    generateSDF(bitmap, *shape, transformation, config);
+/* ============================================================================
+ * Distance precision
+ * ============================================================================ */
 
-    return createBitmapResult(bitmap);
+void msdfgen_set_distance_precision(MsdfgenDistancePrecision precision) {
+    distancePrecision = precision;
 }
 
-MsdfgenBitmap msdfgen_generate_psdf(
-    MsdfgenShape handle,
-    int width, int height,
-    double scaleX, double scaleY,
-    double translateX, double translateY,
-    double rangePixels
-) {
-    return msdfgen_generate_psdf_ex(handle, width, height, scaleX, scaleY, translateX, translateY, rangePixels, 1);
+MsdfgenDistancePrecision msdfgen_get_distance_precision(void) {
+    return static_cast<MsdfgenDistancePrecision>(distancePrecision.load());
 }
 
-MsdfgenBitmap msdfgen_generate_psdf_ex(
-    MsdfgenShape handle,
-    int width, int height,
-    double scaleX, double scaleY,
-    double translateX, double translateY,
-    double rangePixels,
-    int overlapSupport
-) {
-    MsdfgenBitmap result = {nullptr, 0, 0, 0, 0};
-    if (!handle || width <= 0 || height <= 0) return result;
-
-    Shape* shape = static_cast<Shape*>(handle);
-    Bitmap<float, 1> bitmap(width, height);
-
-    Vector2 scale(scaleX, scaleY);
-    Vector2 translate(translateX, translateY);
-    Projection projection(scale, translate);
-    Range range(rangePixels / std::min(scaleX, scaleY));
-    SDFTransformation transformation(projection, range);
-
-    GeneratorConfig config(overlapSupport != 0);
-    generatePSDF(bitmap, *shape, transformation, config);
+/* ============================================================================
+ * Band culling
+ * ============================================================================ */
 
-    return createBitmapResult(bitmap);
+void msdfgen_set_band_culling(MsdfgenBandCulling mode) {
+    bandCulling = mode;
 }
 
-MsdfgenBitmap msdfgen_generate_msdf(
-    MsdfgenShape handle,
-    int width, int height,
-    double scaleX, double scaleY,
-    double translateX, double translateY,
-    double rangePixels
-) {
-    return msdfgen_generate_msdf_ex(handle, width, height, scaleX, scaleY, translateX, translateY, rangePixels, nullptr);
+MsdfgenBandCulling msdfgen_get_band_culling(void) {
+    return static_cast<MsdfgenBandCulling>(bandCulling.load());
 }
 
-MsdfgenBitmap msdfgen_generate_msdf_ex(
-    MsdfgenShape handle,
-    int width, int height,
-    double scaleX, double scaleY,
-    double translateX, double translateY,
-    double rangePixels,
-    const MsdfgenGeneratorConfig* config
-) {
-    MsdfgenBitmap result = {nullptr, 0, 0, 0, 0};
-    if (!handle || width <= 0 || height <= 0) return result;
+/* ============================================================================
+ * Scanline sign
+ * ============================================================================ */
 
-    Shape* shape = static_cast<Shape*>(handle);
-    Bitmap<float, 3> bitmap(width, height);
+void msdfgen_set_scanline_sign(int enabled, MsdfgenFillRule fillRule) {
+    int rule = fillRule >= MSDFGEN_FILL_NONZERO && fillRule <= MSDFGEN_FILL_NEGATIVE ? fillRule : MSDFGEN_FILL_NONZERO;
+    scanlineSign = enabled ? 1 + rule : 0;
+}
 
-    Vector2 scale(scaleX, scaleY);
-    Vector2 translate(translateX, translateY);
-    Projection projection(scale, translate);
-    Range range(rangePixels / std::min(scaleX, scaleY));
-    SDFTransformation transformation(projection, range);
+int msdfgen_get_scanline_sign(MsdfgenFillRule* fillRule) {
+    int sign = scanlineSign.load();
+    if (fillRule) {
+        *fillRule = sign ? static_cast<MsdfgenFillRule>(sign - 1) : MSDFGEN_FILL_NONZERO;
+    }
+    return sign ? 1 : 0;
+}
 
-    MSDFGeneratorConfig genConfig = toMSDFGeneratorConfig(config);
-    generateMSDF(bitmap, *shape, transformation, genConfig);
+/* ============================================================================
+ * Threading
+ * ============================================================================ */
 
-    return createBitmapResult(bitmap);
+void msdfgen_set_thread_count(int threadCount) {
+    threadCountSetting = std::max(0, threadCount);
 }
 
-MsdfgenBitmap msdfgen_generate_mtsdf(
-    MsdfgenShape handle,
-    int width, int height,
-    double scaleX, double scaleY,
-    double translateX, double translateY,
-    double rangePixels
-) {
-    return msdfgen_generate_mtsdf_ex(handle, width, height, scaleX, scaleY, translateX, translateY, rangePixels, nullptr);
+int msdfgen_get_thread_count(void) {
+    int threadCount = threadCountSetting.load();
+    return threadCount > 0 ? threadCount : ThreadPool::hardwareThreads();
 }
 
-MsdfgenBitmap msdfgen_generate_mtsdf_ex(
-    MsdfgenShape handle,
-    int width, int height,
-    double scaleX, double scaleY,
-    double translateX, double translateY,
-    double rangePixels,
-    const MsdfgenGeneratorConfig* config
-) {
-    MsdfgenBitmap result = {nullptr, 0, 0, 0, 0};
-    if (!handle || width <= 0 || height <= 0) return result;
-
-    Shape* shape = static_cast<Shape*>(handle);
-    Bitmap<float, 4> bitmap(width, height);
+/* ============================================================================
+ * Instrumentation
+ * ============================================================================ */
 
-    Vector2 scale(scaleX, scaleY);
-    Vector2 translate(translateX, translateY);
-    Projection projection(scale, translate);
-    Range range(rangePixels / std::min(scaleX, scaleY));
-    SDFTransformation transformation(projection, range);
+void msdfgen_stats_enable(int enabled) {
+    msdfgen_c::setStatsEnabled(enabled != 0);
+}
 
-    MSDFGeneratorConfig genConfig = toMSDFGeneratorConfig(config);
-    generateMTSDF(bitmap, *shape, transformation, genConfig);
+int msdfgen_stats_get(MsdfgenStats* stats) {
+    if (!stats) return 0;
+    msdfgen_c::readStats(*stats);
+    return statsActive() ? 1 : 0;
+}
 
-    return createBitmapResult(bitmap);
+void msdfgen_stats_reset(void) {
+    msdfgen_c::resetStats();
 }
 
 /* ============================================================================
@@ -442,36 +1957,104 @@ void msdfgen_bitmap_to_bytes(
     const MsdfgenBitmap* bitmap,
     unsigned char* output,
     unsigned char edgeValue
+) {
+    msdfgen_bitmap_to_bytes_ex(bitmap, output, 4, edgeValue);
+}
+
+void msdfgen_bitmap_to_bytes_ex(
+    const MsdfgenBitmap* bitmap,
+    unsigned char* output,
+    int outputChannels,
+    unsigned char edgeValue
 ) {
     if (!bitmap || !bitmap->pixels || !output || bitmap->width <= 0 || bitmap->height <= 0) return;
+    if (bitmap->channels <= 0 || outputChannels < 1 || outputChannels > 4) return;
+    StageTimer timer(MSDFGEN_STAGE_CONVERSION);
 
     int width = bitmap->width;
     int height = bitmap->height;
     int channels = bitmap->channels;
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    if (pixelCount < MSDFGEN_C_PARALLEL_CONVERSION_PIXELS) {
+        convertToBytes(bitmap->pixels, channels, output, outputChannels, pixelCount, edgeValue);
+        return;
+    }
 
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int srcIdx = (y * width + x) * channels;
-            int dstIdx = (y * width + x) * 4;
-
-            for (int c = 0; c < std::min(channels, 4); c++) {
-                float val = bitmap->pixels[srcIdx + c];
-                val = std::max(0.0f, std::min(1.0f, val));
+    // Large images are split into bands of rows converted in parallel
+    int rowsPerBand = std::max(1, MSDFGEN_C_PARALLEL_CONVERSION_PIXELS / 4 / width);
+    int bandCount = (height + rowsPerBand - 1) / rowsPerBand;
+    ThreadPool::instance().parallelFor(bandCount, nullptr, resolveThreadCount(0), [&](int band) {
+        int firstRow = band * rowsPerBand;
+        int rows = std::min(rowsPerBand, height - firstRow);
+        size_t firstPixel = static_cast<size_t>(firstRow) * width;
+        convertToBytes(bitmap->pixels + firstPixel * channels, channels, output + firstPixel * outputChannels,
+            outputChannels, static_cast<size_t>(rows) * width, edgeValue);
+    });
+}
 
-                float scaled;
-                if (val <= 0.5f) {
-                    scaled = val * 2.0f * edgeValue;
-                } else {
-                    scaled = edgeValue + (val - 0.5f) * 2.0f * (255 - edgeValue);
-                }
-                output[dstIdx + c] = static_cast<unsigned char>(scaled + 0.5f);
-            }
+int msdfgen_bitmap_to_bytes_view(
+    const MsdfgenBitmapView* bitmap,
+    const MsdfgenBitmapView* output,
+    unsigned char edgeValue
+) {
+    if (!bitmap || !output || bitmap->format != MSDFGEN_PIXEL_FLOAT32 || output->format != MSDFGEN_PIXEL_UINT8) return 0;
+    if (output->channels < 1 || output->channels > 4 || bitmap->width != output->width || bitmap->height != output->height) return 0;
+    ViewRows src, dst;
+    if (bitmap->channels <= 0 || !resolveView(bitmap, bitmap->channels, src) || !resolveView(output, output->channels, dst)) return 0;
+    StageTimer timer(MSDFGEN_STAGE_CONVERSION);
 
-            for (int c = channels; c < 4; c++) {
-                output[dstIdx + c] = 255;
-            }
+    int width = bitmap->width;
+    int height = bitmap->height;
+    int channels = bitmap->channels;
+    int outputChannels = output->channels;
+    auto convertRows = [&](int firstRow, int rows) {
+        for (int y = firstRow; y < firstRow + rows; y++) {
+            convertToBytes(reinterpret_cast<const float*>(src.bottom + y * src.stride), channels, dst.bottom + y * dst.stride, outputChannels, width, edgeValue);
         }
+    };
+    if (static_cast<size_t>(width) * height < MSDFGEN_C_PARALLEL_CONVERSION_PIXELS) {
+        convertRows(0, height);
+        return 1;
+    }
+
+    int rowsPerBand = std::max(1, MSDFGEN_C_PARALLEL_CONVERSION_PIXELS / 4 / width);
+    int bandCount = (height + rowsPerBand - 1) / rowsPerBand;
+    ThreadPool::instance().parallelFor(bandCount, nullptr, resolveThreadCount(0), [&](int band) {
+        int firstRow = band * rowsPerBand;
+        convertRows(firstRow, std::min(rowsPerBand, height - firstRow));
+    });
+    return 1;
+}
+
+MsdfgenBitmapView msdfgen_bitmap_get_view(const MsdfgenBitmap* bitmap) {
+    MsdfgenBitmapView view = {nullptr, 0, 0, 0, 0, MSDFGEN_PIXEL_FLOAT32, MSDFGEN_Y_BOTTOM_UP};
+    if (bitmap && bitmap->pixels) {
+        view.pixels = bitmap->pixels;
+        view.width = bitmap->width;
+        view.height = bitmap->height;
+        view.channels = bitmap->channels;
     }
+    return view;
+}
+
+MsdfgenBitmapView msdfgen_bitmap_view_window(
+    const MsdfgenBitmapView* view,
+    int x, int y,
+    int width, int height
+) {
+    MsdfgenBitmapView window = {nullptr, 0, 0, 0, 0, MSDFGEN_PIXEL_FLOAT32, MSDFGEN_Y_BOTTOM_UP};
+    if (!view || !view->pixels || view->channels <= 0) return window;
+    size_t valueSize = pixelFormatSize(view->format);
+    if (!valueSize || !validRegion(view->width, view->height, x, y, width, height)) return window;
+    size_t stride = validRowStride(view->rowStride, view->width, view->channels, valueSize);
+    if (!stride || stride > static_cast<size_t>(INT_MAX)) return window;
+    window = *view;
+    window.pixels = static_cast<unsigned char*>(view->pixels) + static_cast<size_t>(y) * stride + static_cast<size_t>(x) * view->channels * valueSize;
+    window.width = width;
+    window.height = height;
+    // The window's rows are as far apart as the view's, which are not tightly packed for it
+    window.rowStride = static_cast<int>(stride);
+    return window;
 }
 
 /* ============================================================================
@@ -500,18 +2083,21 @@ int msdfgen_resolve_shape_geometry(MsdfgenShape handle) {
 int msdfgen_shape_load_from_svg_path(MsdfgenShape handle, const char* pathDef, double endpointSnapRange) {
     if (!handle || !pathDef) return 0;
     Shape* shape = static_cast<Shape*>(handle);
+    StageTimer timer(MSDFGEN_STAGE_SHAPE_LOADING);
     return buildShapeFromSvgPath(*shape, pathDef, endpointSnapRange) ? 1 : 0;
 }
 
 int msdfgen_shape_load_from_svg_file(MsdfgenShape handle, const char* filename, int pathIndex) {
     if (!handle || !filename) return 0;
     Shape* shape = static_cast<Shape*>(handle);
+    StageTimer timer(MSDFGEN_STAGE_SHAPE_LOADING);
     return loadSvgShape(*shape, filename, pathIndex, nullptr) ? 1 : 0;
 }
 
 int msdfgen_shape_load_from_svg_file_ex(MsdfgenShape handle, MsdfgenBounds* viewBox, const char* filename) {
     if (!handle || !filename) return 0;
     Shape* shape = static_cast<Shape*>(handle);
+    StageTimer timer(MSDFGEN_STAGE_SHAPE_LOADING);
     Shape::Bounds bounds;
     int result = loadSvgShape(*shape, bounds, filename);
     if (viewBox) {
@@ -536,35 +2122,46 @@ int msdfgen_shape_load_from_svg_file_ex(MsdfgenShape, MsdfgenBounds*, const char
  * ============================================================================ */
 
 MsdfgenFreetype msdfgen_freetype_init(void) {
-    return initializeFreetype();
+    return msdfgen_c::createFreetype();
 }
 
 void msdfgen_freetype_deinit(MsdfgenFreetype freetype) {
     if (freetype) {
-        deinitializeFreetype(static_cast<FreetypeHandle*>(freetype));
+        msdfgen_c::destroyFreetype(static_cast<msdfgen_c::Freetype*>(freetype));
     }
 }
 
 MsdfgenFont msdfgen_font_load(MsdfgenFreetype freetype, const char* filename) {
     if (!freetype || !filename) return nullptr;
-    return loadFont(static_cast<FreetypeHandle*>(freetype), filename);
+    return msdfgen_c::openFont(*static_cast<msdfgen_c::Freetype*>(freetype), filename);
 }
 
 MsdfgenFont msdfgen_font_load_data(MsdfgenFreetype freetype, const unsigned char* data, int length) {
     if (!freetype || !data || length <= 0) return nullptr;
-    return loadFontData(static_cast<FreetypeHandle*>(freetype), data, length);
+    return msdfgen_c::openFontData(*static_cast<msdfgen_c::Freetype*>(freetype), data, length);
+}
+
+MsdfgenFont msdfgen_font_load_concurrent(MsdfgenFreetype freetype, const char* filename) {
+    if (!freetype || !filename) return nullptr;
+    return msdfgen_c::openConcurrentFont(*static_cast<msdfgen_c::Freetype*>(freetype), filename);
 }
 
 void msdfgen_font_destroy(MsdfgenFont font) {
     if (font) {
-        destroyFont(static_cast<FontHandle*>(font));
+        msdfgen_c::closeFont(static_cast<msdfgen_c::Font*>(font));
     }
 }
 
+int msdfgen_font_set_glyph_cache(MsdfgenFont font, unsigned long long maxBytes) {
+    if (!font) return 0;
+    static_cast<msdfgen_c::Font*>(font)->glyphCache.setBudget(static_cast<size_t>(std::min<unsigned long long>(maxBytes, SIZE_MAX)));
+    return 1;
+}
+
 int msdfgen_font_get_metrics(MsdfgenFont font, MsdfgenFontMetrics* metrics, MsdfgenFontCoordinateScaling scaling) {
     if (!font || !metrics) return 0;
     FontMetrics m;
-    if (!getFontMetrics(m, static_cast<FontHandle*>(font), toFontScaling(scaling))) {
+    if (!getFontMetrics(m, fontHandle(font), toFontScaling(scaling))) {
         return 0;
     }
     metrics->emSize = m.emSize;
@@ -579,7 +2176,7 @@ int msdfgen_font_get_metrics(MsdfgenFont font, MsdfgenFontMetrics* metrics, Msdf
 int msdfgen_font_get_whitespace_width(MsdfgenFont font, double* spaceAdvance, double* tabAdvance, MsdfgenFontCoordinateScaling scaling) {
     if (!font) return 0;
     double space = 0, tab = 0;
-    if (!getFontWhitespaceWidth(space, tab, static_cast<FontHandle*>(font), toFontScaling(scaling))) {
+    if (!getFontWhitespaceWidth(space, tab, fontHandle(font), toFontScaling(scaling))) {
         return 0;
     }
     if (spaceAdvance) *spaceAdvance = space;
@@ -590,7 +2187,7 @@ int msdfgen_font_get_whitespace_width(MsdfgenFont font, double* spaceAdvance, do
 int msdfgen_font_get_glyph_count(MsdfgenFont font, unsigned int* count) {
     if (!font || !count) return 0;
     unsigned c = 0;
-    if (!getGlyphCount(c, static_cast<FontHandle*>(font))) {
+    if (!getGlyphCount(c, fontHandle(font))) {
         return 0;
     }
     *count = c;
@@ -600,7 +2197,7 @@ int msdfgen_font_get_glyph_count(MsdfgenFont font, unsigned int* count) {
 int msdfgen_font_get_glyph_index(MsdfgenFont font, unsigned int unicode, unsigned int* glyphIndex) {
     if (!font || !glyphIndex) return 0;
     GlyphIndex idx;
-    if (!getGlyphIndex(idx, static_cast<FontHandle*>(font), unicode)) {
+    if (!getGlyphIndex(idx, fontHandle(font), unicode)) {
         return 0;
     }
     *glyphIndex = idx.getIndex();
@@ -615,13 +2212,8 @@ int msdfgen_font_load_glyph(
     double* outAdvance
 ) {
     if (!handle || !font) return 0;
-    Shape* shape = static_cast<Shape*>(handle);
-    double advance = 0;
-    if (!loadGlyph(*shape, static_cast<FontHandle*>(font), unicode, toFontScaling(scaling), &advance)) {
-        return 0;
-    }
-    if (outAdvance) *outAdvance = advance;
-    return 1;
+    unsigned glyphIndex = msdfgen_c::fontGlyphIndex(*static_cast<msdfgen_c::Font*>(font), unicode);
+    return msdfgen_font_load_glyph_by_index(handle, font, glyphIndex, scaling, outAdvance);
 }
 
 int msdfgen_font_load_glyph_by_index(
@@ -632,9 +2224,9 @@ int msdfgen_font_load_glyph_by_index(
     double* outAdvance
 ) {
     if (!handle || !font) return 0;
-    Shape* shape = static_cast<Shape*>(handle);
+    StageTimer timer(MSDFGEN_STAGE_SHAPE_LOADING);
     double advance = 0;
-    if (!loadGlyph(*shape, static_cast<FontHandle*>(font), GlyphIndex(glyphIndex), toFontScaling(scaling), &advance)) {
+    if (!msdfgen_c::loadPooledGlyph(*toPooledShape(handle), *static_cast<msdfgen_c::Font*>(font), glyphIndex, toFontScaling(scaling), &advance)) {
         return 0;
     }
     if (outAdvance) *outAdvance = advance;
@@ -650,7 +2242,7 @@ int msdfgen_font_get_kerning(
 ) {
     if (!font || !kerning) return 0;
     double k = 0;
-    if (!getKerning(k, static_cast<FontHandle*>(font), unicode0, unicode1, toFontScaling(scaling))) {
+    if (!getKerning(k, fontHandle(font), unicode0, unicode1, toFontScaling(scaling))) {
         return 0;
     }
     *kerning = k;
@@ -666,13 +2258,36 @@ int msdfgen_font_get_kerning_by_index(
 ) {
     if (!font || !kerning) return 0;
     double k = 0;
-    if (!getKerning(k, static_cast<FontHandle*>(font), GlyphIndex(glyphIndex0), GlyphIndex(glyphIndex1), toFontScaling(scaling))) {
+    if (!getKerning(k, fontHandle(font), GlyphIndex(glyphIndex0), GlyphIndex(glyphIndex1), toFontScaling(scaling))) {
         return 0;
     }
     *kerning = k;
     return 1;
 }
 
+int msdfgen_font_get_kerning_table(
+    MsdfgenFont font,
+    const unsigned int* glyphIndices,
+    int glyphCount,
+    MsdfgenFontCoordinateScaling scaling,
+    double* advances,
+    MsdfgenKerningPair* pairs,
+    int* pairCount
+) {
+    if (!font || !pairCount || glyphCount < 0 || (glyphCount > 0 && !glyphIndices)) return 0;
+    msdfgen_c::Font* f = static_cast<msdfgen_c::Font*>(font);
+    if (advances && !msdfgen_c::getGlyphAdvances(*f, glyphIndices, glyphCount, toFontScaling(scaling), advances)) return 0;
+
+    std::vector<MsdfgenKerningPair> table;
+    if (!msdfgen_c::getKerningPairs(*f, glyphIndices, glyphCount, toFontScaling(scaling), table)) return 0;
+    int capacity = *pairCount;
+    *pairCount = static_cast<int>(table.size());
+    if (!pairs) return 1;
+    if (static_cast<size_t>(capacity) < table.size()) return 0;
+    std::copy(table.begin(), table.end(), pairs);
+    return 1;
+}
+
 #ifndef MSDFGEN_DISABLE_VARIABLE_FONTS
 
 int msdfgen_font_set_variation_axis(
@@ -682,7 +2297,7 @@ int msdfgen_font_set_variation_axis(
     double coordinate
 ) {
     if (!freetype || !font || !name) return 0;
-    return setFontVariationAxis(static_cast<FreetypeHandle*>(freetype), static_cast<FontHandle*>(font), name, coordinate) ? 1 : 0;
+    return msdfgen_c::setFontVariationAxis(*static_cast<msdfgen_c::Freetype*>(freetype), *static_cast<msdfgen_c::Font*>(font), name, coordinate) ? 1 : 0;
 }
 
 int msdfgen_font_get_variation_axis_count(
@@ -690,13 +2305,8 @@ int msdfgen_font_get_variation_axis_count(
     MsdfgenFont font,
     int* count
 ) {
-    if (!freetype || !font || !count) return 0;
-    std::vector<FontVariationAxis> axes;
-    if (!listFontVariationAxes(axes, static_cast<FreetypeHandle*>(freetype), static_cast<FontHandle*>(font))) {
-        return 0;
-    }
-    *count = static_cast<int>(axes.size());
-    return 1;
+    const MsdfgenFontVariationAxis* axes;
+    return msdfgen_font_get_variation_axes(freetype, font, &axes, count);
 }
 
 int msdfgen_font_get_variation_axis(
@@ -705,24 +2315,116 @@ int msdfgen_font_get_variation_axis(
     int index,
     MsdfgenFontVariationAxis* axis
 ) {
-    if (!freetype || !font || !axis || index < 0) return 0;
-    std::vector<FontVariationAxis> axes;
-    if (!listFontVariationAxes(axes, static_cast<FreetypeHandle*>(freetype), static_cast<FontHandle*>(font))) {
-        return 0;
-    }
-    if (index >= static_cast<int>(axes.size())) return 0;
-    axis->name = axes[index].name;
-    axis->minValue = axes[index].minValue;
-    axis->maxValue = axes[index].maxValue;
-    axis->defaultValue = axes[index].defaultValue;
+    if (!axis || index < 0) return 0;
+    const MsdfgenFontVariationAxis* axes;
+    int count;
+    if (!msdfgen_font_get_variation_axes(freetype, font, &axes, &count) || index >= count) return 0;
+    *axis = axes[index];
+    return 1;
+}
+
+int msdfgen_font_get_variation_axes(
+    MsdfgenFreetype freetype,
+    MsdfgenFont font,
+    const MsdfgenFontVariationAxis** axes,
+    int* count
+) {
+    if (!freetype || !font || !axes || !count) return 0;
+    const std::vector<MsdfgenFontVariationAxis>* list = msdfgen_c::fontVariationAxes(*static_cast<msdfgen_c::Freetype*>(freetype), *static_cast<msdfgen_c::Font*>(font));
+    if (!list) return 0;
+    *axes = list->data();
+    *count = static_cast<int>(list->size());
     return 1;
 }
 
+int msdfgen_font_set_variation_coordinates(
+    MsdfgenFreetype freetype,
+    MsdfgenFont font,
+    const double* coordinates,
+    int count
+) {
+    if (!freetype || !font || !coordinates) return 0;
+    msdfgen_c::Freetype& ft = *static_cast<msdfgen_c::Freetype*>(freetype);
+    msdfgen_c::Font& f = *static_cast<msdfgen_c::Font*>(font);
+    const std::vector<MsdfgenFontVariationAxis>* axes = msdfgen_c::fontVariationAxes(ft, f);
+    if (!axes || count != static_cast<int>(axes->size())) return 0;
+    return msdfgen_c::setFontVariationCoordinates(ft, f, coordinates) ? 1 : 0;
+}
+
+int msdfgen_font_generate_instance_atlases(
+    MsdfgenFreetype freetype,
+    MsdfgenFont font,
+    const unsigned int* glyphIndices,
+    int glyphCount,
+    MsdfgenFontCoordinateScaling scaling,
+    const double* coordinates,
+    int instanceCount,
+    double angleThreshold,
+    const MsdfgenAtlasConfig* config,
+    MsdfgenAtlas* atlases,
+    double* advances
+) {
+    if (!freetype || !font || !glyphIndices || glyphCount <= 0 || !coordinates || instanceCount <= 0 || !config || !atlases) return 0;
+    for (int i = 0; i < instanceCount; i++) {
+        atlases[i] = MsdfgenAtlas{nullptr, 0, 0, 0, MSDFGEN_PIXEL_FLOAT32, nullptr, 0, 0};
+    }
+    msdfgen_c::Freetype& ft = *static_cast<msdfgen_c::Freetype*>(freetype);
+    msdfgen_c::Font& f = *static_cast<msdfgen_c::Font*>(font);
+    std::vector<double> original;
+    if (!msdfgen_c::getFontVariationCoordinates(ft, f, original)) return 0;
+    size_t axisCount = original.size();
+    bool colorEdges = config->type == MSDFGEN_BITMAP_MSDF || config->type == MSDFGEN_BITMAP_MTSDF;
+
+    // The shapes are refilled for every instance, reusing their storage
+    std::vector<PooledShape> shapes(glyphCount);
+    std::vector<MsdfgenShape> handles(glyphCount);
+    for (int i = 0; i < glyphCount; i++) {
+        handles[i] = static_cast<Shape*>(&shapes[i]);
+    }
+
+    int succeeded = 0;
+    for (int instance = 0; instance < instanceCount; instance++) {
+        if (!msdfgen_c::setFontVariationCoordinates(ft, f, coordinates + instance * axisCount)) continue;
+        bool loaded = true;
+        try {
+            for (int i = 0; i < glyphCount && loaded; i++) {
+                double advance = 0;
+                {
+                    StageTimer timer(MSDFGEN_STAGE_SHAPE_LOADING);
+                    loaded = msdfgen_c::loadPooledGlyph(shapes[i], f, glyphIndices[i], toFontScaling(scaling), &advance);
+                }
+                if (!loaded) break;
+                shapes[i].normalize();
+                if (colorEdges) {
+                    StageTimer timer(MSDFGEN_STAGE_EDGE_COLORING);
+                    edgeColoringSimple(shapes[i], angleThreshold, 0);
+                }
+                if (advances) {
+                    advances[instance * glyphCount + i] = advance;
+                }
+            }
+        } catch (...) {
+            loaded = false;
+        }
+        if (!loaded) continue;
+        atlases[instance] = msdfgen_generate_atlas(handles.data(), glyphCount, config);
+        if (atlases[instance].success) {
+            ++succeeded;
+        }
+    }
+
+    msdfgen_c::setFontVariationCoordinates(ft, f, original.data());
+    return succeeded;
+}
+
 #else
 
 int msdfgen_font_set_variation_axis(MsdfgenFreetype, MsdfgenFont, const char*, double) { return 0; }
 int msdfgen_font_get_variation_axis_count(MsdfgenFreetype, MsdfgenFont, int*) { return 0; }
 int msdfgen_font_get_variation_axis(MsdfgenFreetype, MsdfgenFont, int, MsdfgenFontVariationAxis*) { return 0; }
+int msdfgen_font_get_variation_axes(MsdfgenFreetype, MsdfgenFont, const MsdfgenFontVariationAxis**, int*) { return 0; }
+int msdfgen_font_set_variation_coordinates(MsdfgenFreetype, MsdfgenFont, const double*, int) { return 0; }
+int msdfgen_font_generate_instance_atlases(MsdfgenFreetype, MsdfgenFont, const unsigned int*, int, MsdfgenFontCoordinateScaling, const double*, int, double, const MsdfgenAtlasConfig*, MsdfgenAtlas*, double*) { return 0; }
 
 #endif
 
@@ -736,7 +2438,9 @@ MsdfgenFreetype msdfgen_freetype_init(void) { return nullptr; }
 void msdfgen_freetype_deinit(MsdfgenFreetype) {}
 MsdfgenFont msdfgen_font_load(MsdfgenFreetype, const char*) { return nullptr; }
 MsdfgenFont msdfgen_font_load_data(MsdfgenFreetype, const unsigned char*, int) { return nullptr; }
+MsdfgenFont msdfgen_font_load_concurrent(MsdfgenFreetype, const char*) { return nullptr; }
 void msdfgen_font_destroy(MsdfgenFont) {}
+int msdfgen_font_set_glyph_cache(MsdfgenFont, unsigned long long) { return 0; }
 int msdfgen_font_get_metrics(MsdfgenFont, MsdfgenFontMetrics*, MsdfgenFontCoordinateScaling) { return 0; }
 int msdfgen_font_get_whitespace_width(MsdfgenFont, double*, double*, MsdfgenFontCoordinateScaling) { return 0; }
 int msdfgen_font_get_glyph_count(MsdfgenFont, unsigned int*) { return 0; }
@@ -745,9 +2449,13 @@ int msdfgen_font_load_glyph(MsdfgenShape, MsdfgenFont, unsigned int, MsdfgenFont
 int msdfgen_font_load_glyph_by_index(MsdfgenShape, MsdfgenFont, unsigned int, MsdfgenFontCoordinateScaling, double*) { return 0; }
 int msdfgen_font_get_kerning(MsdfgenFont, unsigned int, unsigned int, MsdfgenFontCoordinateScaling, double*) { return 0; }
 int msdfgen_font_get_kerning_by_index(MsdfgenFont, unsigned int, unsigned int, MsdfgenFontCoordinateScaling, double*) { return 0; }
+int msdfgen_font_get_kerning_table(MsdfgenFont, const unsigned int*, int, MsdfgenFontCoordinateScaling, double*, MsdfgenKerningPair*, int*) { return 0; }
 int msdfgen_font_set_variation_axis(MsdfgenFreetype, MsdfgenFont, const char*, double) { return 0; }
 int msdfgen_font_get_variation_axis_count(MsdfgenFreetype, MsdfgenFont, int*) { return 0; }
 int msdfgen_font_get_variation_axis(MsdfgenFreetype, MsdfgenFont, int, MsdfgenFontVariationAxis*) { return 0; }
+int msdfgen_font_get_variation_axes(MsdfgenFreetype, MsdfgenFont, const MsdfgenFontVariationAxis**, int*) { return 0; }
+int msdfgen_font_set_variation_coordinates(MsdfgenFreetype, MsdfgenFont, const double*, int) { return 0; }
+int msdfgen_font_generate_instance_atlases(MsdfgenFreetype, MsdfgenFont, const unsigned int*, int, MsdfgenFontCoordinateScaling, const double*, int, double, const MsdfgenAtlasConfig*, MsdfgenAtlas*, double*) { return 0; }
 
 #endif // MSDFGEN_USE_EXTENSIONS
 
@@ -808,4 +2516,12 @@ int msdfgen_has_extension_support(void) {
 #endif
 }
 
+int msdfgen_has_parallel_generation(void) {
+#ifdef MSDFGEN_USE_OPENMP
+    return 1;
+#else
+    return 0;
+#endif
+}
+
 } // extern "C"
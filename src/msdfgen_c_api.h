@@ -29,6 +29,7 @@ extern "C" {
 typedef void* MsdfgenShape;
 typedef void* MsdfgenFreetype;
 typedef void* MsdfgenFont;
+typedef void* MsdfgenJob;
 
 /* ============================================================================
  * Enumerations
@@ -50,7 +51,18 @@ typedef enum {
     MSDFGEN_ERROR_CORRECTION_DISABLED = 0,
     MSDFGEN_ERROR_CORRECTION_INDISCRIMINATE = 1,
     MSDFGEN_ERROR_CORRECTION_EDGE_PRIORITY = 2,
-    MSDFGEN_ERROR_CORRECTION_EDGE_ONLY = 3
+    MSDFGEN_ERROR_CORRECTION_EDGE_ONLY = 3,
+    /*
+     * Faster passes that work on the field alone, without protecting corners and
+     * edges or checking distances against the shape; distanceCheckMode and
+     * minImproveRatio are ignored. FAST_DISTANCE corrects every texel that looks
+     * erroneous, like INDISCRIMINATE, and FAST_EDGE only those at edges. LEGACY
+     * is msdfgen's original clash detection, with minDeviationRatio as its
+     * threshold in pixels of distance.
+     */
+    MSDFGEN_ERROR_CORRECTION_FAST_DISTANCE = 4,
+    MSDFGEN_ERROR_CORRECTION_FAST_EDGE = 5,
+    MSDFGEN_ERROR_CORRECTION_LEGACY = 6
 } MsdfgenErrorCorrectionMode;
 
 typedef enum {
@@ -65,6 +77,68 @@ typedef enum {
     MSDFGEN_FONT_SCALING_LEGACY = 2
 } MsdfgenFontCoordinateScaling;
 
+typedef enum {
+    MSDFGEN_BITMAP_SDF = 0,
+    MSDFGEN_BITMAP_PSDF = 1,
+    MSDFGEN_BITMAP_MSDF = 2,
+    MSDFGEN_BITMAP_MTSDF = 3
+} MsdfgenBitmapType;
+
+typedef enum {
+    MSDFGEN_ACCELERATION_AUTO = 0,      /* Edge hierarchy for shapes with many edges */
+    MSDFGEN_ACCELERATION_DISABLED = 1,
+    MSDFGEN_ACCELERATION_ALWAYS = 2
+} MsdfgenDistanceAcceleration;
+
+typedef enum {
+    MSDFGEN_PRECISION_DOUBLE = 0,
+    MSDFGEN_PRECISION_FLOAT = 1
+} MsdfgenDistancePrecision;
+
+typedef enum {
+    MSDFGEN_BAND_CULLING_DISABLED = 0,
+    MSDFGEN_BAND_CULLING_ENABLED = 1    /* Pixels beyond the range are set without evaluating every edge */
+} MsdfgenBandCulling;
+
+/* Path verbs of msdfgen_shape_build_from_arrays, with the number of points each consumes */
+typedef enum {
+    MSDFGEN_VERB_MOVE = 0,          /* 1 point: starts a new contour */
+    MSDFGEN_VERB_LINE = 1,          /* 1 point: end point */
+    MSDFGEN_VERB_QUADRATIC = 2,     /* 2 points: control point, end point */
+    MSDFGEN_VERB_CUBIC = 3,         /* 3 points: two control points, end point */
+    MSDFGEN_VERB_CLOSE = 4          /* 0 points: ends the current contour */
+} MsdfgenPathVerb;
+
+/* Stages timed by the instrumentation counters */
+typedef enum {
+    MSDFGEN_STAGE_SHAPE_LOADING = 0,        /* FreeType glyph decoding and SVG import */
+    MSDFGEN_STAGE_EDGE_COLORING = 1,
+    MSDFGEN_STAGE_DISTANCE = 2,             /* Distance evaluation of the generators */
+    MSDFGEN_STAGE_ERROR_CORRECTION = 3,     /* MSDF error correction */
+    MSDFGEN_STAGE_CONVERSION = 4,           /* Storing fields in output formats and byte conversion */
+    MSDFGEN_STAGE_COUNT = 5
+} MsdfgenStage;
+
+/* Storage of generated values; UINT8 and UINT16 map [0, 1] onto their full range */
+typedef enum {
+    MSDFGEN_PIXEL_FLOAT32 = 0,
+    MSDFGEN_PIXEL_UINT8 = 1,
+    MSDFGEN_PIXEL_UINT16 = 2,
+    MSDFGEN_PIXEL_FLOAT16 = 3
+} MsdfgenPixelFormat;
+
+/* State of an asynchronous job; DONE, FAILED and CANCELLED are final */
+typedef enum {
+    MSDFGEN_JOB_PENDING = 0,
+    MSDFGEN_JOB_RUNNING = 1,
+    MSDFGEN_JOB_DONE = 2,
+    MSDFGEN_JOB_FAILED = 3,
+    MSDFGEN_JOB_CANCELLED = 4
+} MsdfgenJobStatus;
+
+/* Called once per job when it reaches a final status */
+typedef void (*MsdfgenJobCallback)(MsdfgenJob job, MsdfgenJobStatus status, void* userData);
+
 /* ============================================================================
  * Structures
  * ============================================================================ */
@@ -84,6 +158,23 @@ typedef struct {
     int success;
 } MsdfgenBitmap;
 
+/*
+ * A window of caller-owned pixel storage, such as a glyph's slot in an atlas or in a
+ * mapped texture upload buffer. Rows are rowStride bytes apart, 0 for tightly packed
+ * rows. With MSDFGEN_Y_BOTTOM_UP the first row in memory is the bottom of the image,
+ * as in MsdfgenBitmap; with MSDFGEN_Y_TOP_DOWN it is the top, and rows are stored in
+ * reverse without a separate flip.
+ */
+typedef struct {
+    void* pixels;       /* First pixel of the first row in memory */
+    int width;
+    int height;
+    int channels;
+    int rowStride;
+    MsdfgenPixelFormat format;
+    MsdfgenYAxisOrientation yOrientation;
+} MsdfgenBitmapView;
+
 typedef struct {
     MsdfgenErrorCorrectionMode mode;
     MsdfgenDistanceCheckMode distanceCheckMode;
@@ -96,6 +187,68 @@ typedef struct {
     MsdfgenErrorCorrectionConfig errorCorrection;
 } MsdfgenGeneratorConfig;
 
+/* One glyph of a batch; the generator config also applies to SDF/PSDF (overlapSupport only) */
+typedef struct {
+    MsdfgenShape shape;
+    MsdfgenBitmapType type;
+    int width;
+    int height;
+    double scaleX;
+    double scaleY;
+    double translateX;
+    double translateY;
+    double rangePixels;
+    MsdfgenGeneratorConfig config;
+} MsdfgenBatchItem;
+
+typedef struct {
+    MsdfgenBitmapType type;
+    MsdfgenPixelFormat format;  /* Storage of atlas pixels */
+    double scale;               /* Atlas pixels per shape unit, shared by all glyphs */
+    double rangePixels;
+    int spacing;                /* Empty pixels left between glyph rectangles */
+    int width;                  /* Atlas size, 0 to pick the smallest power of two that fits */
+    int height;
+    MsdfgenGeneratorConfig generator;
+    int threadCount;            /* <= 0 uses msdfgen_get_thread_count() */
+} MsdfgenAtlasConfig;
+
+typedef struct {
+    int x;                      /* Rectangle in the atlas; y counts rows of the pixel buffer */
+    int y;
+    int width;                  /* 0 for empty shapes (e.g. whitespace) */
+    int height;
+    MsdfgenBounds planeBounds;  /* Area of shape space covered by the rectangle */
+} MsdfgenAtlasGlyph;
+
+typedef struct {
+    void* pixels;               /* width x height x channels values in format */
+    int width;
+    int height;
+    int channels;
+    MsdfgenPixelFormat format;
+    MsdfgenAtlasGlyph* glyphs;  /* One entry per input shape, in input order */
+    int glyphCount;
+    int success;
+} MsdfgenAtlas;
+
+/* Instrumentation counters summed over all threads since the last reset */
+typedef struct {
+    unsigned long long stageNanoseconds[MSDFGEN_STAGE_COUNT];
+    unsigned long long stageCalls[MSDFGEN_STAGE_COUNT];
+    unsigned long long pixelsGenerated;     /* Including pixels generated only as neighbors for error correction */
+    unsigned long long edgeEvaluations;     /* Pixel-edge distance queries; the edge hierarchy counts the edges it visits */
+    unsigned long long correctedPixels;     /* Pixels changed by MSDF error correction */
+} MsdfgenStats;
+
+/* Counters of the in-memory result cache since it was last cleared */
+typedef struct {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long entries;
+    unsigned long long bytes;           /* Payload and bookkeeping of the cached results */
+} MsdfgenMemoryCacheStats;
+
 typedef struct {
     double emSize;
     double ascenderY;
@@ -105,6 +258,12 @@ typedef struct {
     double underlineThickness;
 } MsdfgenFontMetrics;
 
+typedef struct {
+    unsigned int glyphIndex0;   /* Left glyph */
+    unsigned int glyphIndex1;   /* Right glyph */
+    double kerning;
+} MsdfgenKerningPair;
+
 typedef struct {
     const char* name;
     double minValue;
@@ -119,6 +278,14 @@ typedef struct {
 MSDFGEN_C_API MsdfgenShape msdfgen_shape_create(void);
 MSDFGEN_C_API void msdfgen_shape_destroy(MsdfgenShape shape);
 
+/*
+ * Removes all contours and restores the default Y axis orientation. The shape keeps
+ * its contour and edge storage and reuses it for edges added later, including glyphs
+ * loaded with msdfgen_font_load_glyph, so refilling a shape stops allocating once it
+ * has held outlines of similar size.
+ */
+MSDFGEN_C_API void msdfgen_shape_reset(MsdfgenShape shape);
+
 /* ============================================================================
  * Contour and edge operations
  * ============================================================================ */
@@ -149,6 +316,35 @@ MSDFGEN_C_API void msdfgen_contour_add_cubic(
     double x3, double y3
 );
 
+/*
+ * Appends all contours of a path in one call. verbs holds verbCount MsdfgenPathVerb
+ * values and points holds pointCount x, y pairs, consumed in order. Every contour
+ * starts with MOVE and is closed with a line back to its start if its last point
+ * differs; CLOSE is optional. Returns 0 without modifying the shape if the path is
+ * malformed.
+ */
+MSDFGEN_C_API int msdfgen_shape_build_from_arrays(
+    MsdfgenShape shape,
+    const unsigned char* verbs,
+    int verbCount,
+    const double* points,
+    int pointCount
+);
+
+/*
+ * Writes the shape's geometry in the layout of msdfgen_shape_build_from_arrays:
+ * MOVE, one verb per edge and CLOSE for every non-empty contour. On input verbCount
+ * and pointCount hold the buffer capacities, on output the required sizes; pass
+ * NULL buffers to only query the sizes. Returns 0 if the buffers are too small.
+ */
+MSDFGEN_C_API int msdfgen_shape_export_arrays(
+    MsdfgenShape shape,
+    unsigned char* verbs,
+    int* verbCount,
+    double* points,
+    int* pointCount
+);
+
 /* ============================================================================
  * Shape operations
  * ============================================================================ */
@@ -251,6 +447,463 @@ MSDFGEN_C_API MsdfgenBitmap msdfgen_generate_mtsdf_ex(
     const MsdfgenGeneratorConfig* config
 );
 
+/*
+ * Zero-copy versions writing into caller-owned memory laid out like MsdfgenBitmap.
+ * rowStride is the distance between rows in bytes, 0 for tightly packed rows.
+ * Return 1 on success.
+ */
+MSDFGEN_C_API int msdfgen_generate_sdf_into(
+    MsdfgenShape shape,
+    float* pixels,
+    int width, int height,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    int overlapSupport
+);
+
+MSDFGEN_C_API int msdfgen_generate_psdf_into(
+    MsdfgenShape shape,
+    float* pixels,
+    int width, int height,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    int overlapSupport
+);
+
+MSDFGEN_C_API int msdfgen_generate_msdf_into(
+    MsdfgenShape shape,
+    float* pixels,
+    int width, int height,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+);
+
+MSDFGEN_C_API int msdfgen_generate_mtsdf_into(
+    MsdfgenShape shape,
+    float* pixels,
+    int width, int height,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+);
+
+/*
+ * Generates a bitmap of any type into caller-owned memory in the given pixel format.
+ * Formats other than packed float are produced in strips through a small per-thread
+ * float buffer, so no full-size float copy of the field is allocated.
+ * rowStride is in bytes, 0 for tightly packed rows. A null config uses the defaults.
+ * Returns 1 on success.
+ */
+MSDFGEN_C_API int msdfgen_generate_into_format(
+    MsdfgenShape shape,
+    MsdfgenBitmapType type,
+    MsdfgenPixelFormat format,
+    void* pixels,
+    int width, int height,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+);
+
+/*
+ * Generates a bitmap of any type into a view of view->width x view->height pixels in
+ * the view's format, row order and stride. view->channels must be those of type.
+ * Returns 1 on success.
+ */
+MSDFGEN_C_API int msdfgen_generate_view(
+    MsdfgenShape shape,
+    MsdfgenBitmapType type,
+    const MsdfgenBitmapView* view,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+);
+
+/* Bytes per channel of format, 0 if unknown */
+MSDFGEN_C_API int msdfgen_pixel_format_size(MsdfgenPixelFormat format);
+
+/* ============================================================================
+ * Region generation
+ * ============================================================================ */
+
+/*
+ * Generate the regionWidth x regionHeight pixels at regionX, regionY of a
+ * fieldWidth x fieldHeight bitmap that the other generators would produce with
+ * the same transformation. Region coordinates follow the bitmap's memory layout:
+ * regionY counts rows from the start of the buffer. pixels receives the region
+ * only, so it may point into the full bitmap with the full bitmap's rowStride.
+ * MSDF error correction sees each pixel's neighbors across region borders, so
+ * regions tile seamlessly into the full-size result. Disjoint regions of the same
+ * shape may be generated concurrently.
+ * rowStride is in bytes, 0 for tightly packed region rows. Return 1 on success.
+ */
+MSDFGEN_C_API int msdfgen_generate_sdf_region(
+    MsdfgenShape shape,
+    float* pixels,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    int regionWidth, int regionHeight,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    int overlapSupport
+);
+
+MSDFGEN_C_API int msdfgen_generate_psdf_region(
+    MsdfgenShape shape,
+    float* pixels,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    int regionWidth, int regionHeight,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    int overlapSupport
+);
+
+MSDFGEN_C_API int msdfgen_generate_msdf_region(
+    MsdfgenShape shape,
+    float* pixels,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    int regionWidth, int regionHeight,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+);
+
+MSDFGEN_C_API int msdfgen_generate_mtsdf_region(
+    MsdfgenShape shape,
+    float* pixels,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    int regionWidth, int regionHeight,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+);
+
+/* Region counterpart of msdfgen_generate_into_format */
+MSDFGEN_C_API int msdfgen_generate_region_into_format(
+    MsdfgenShape shape,
+    MsdfgenBitmapType type,
+    MsdfgenPixelFormat format,
+    void* pixels,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    int regionWidth, int regionHeight,
+    int rowStride,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+);
+
+/*
+ * Region counterpart of msdfgen_generate_view: the region is the view's size, and
+ * regionY counts rows in the view's row order, from the top of the field for
+ * MSDFGEN_Y_TOP_DOWN views.
+ */
+MSDFGEN_C_API int msdfgen_generate_region_view(
+    MsdfgenShape shape,
+    MsdfgenBitmapType type,
+    const MsdfgenBitmapView* view,
+    int fieldWidth, int fieldHeight,
+    int regionX, int regionY,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+);
+
+/* ============================================================================
+ * Error correction
+ * ============================================================================ */
+
+/*
+ * Runs MSDF error correction with config->errorCorrection on an existing MSDF or
+ * MTSDF bitmap generated with the given framing, e.g. one generated with error
+ * correction disabled. The exact modes need the shape the bitmap was generated
+ * from; the fast and legacy modes accept a NULL shape. config may be NULL for
+ * the defaults. Returns 0 if the bitmap has neither 3 nor 4 channels.
+ */
+MSDFGEN_C_API int msdfgen_error_correction(
+    MsdfgenBitmap* bitmap,
+    MsdfgenShape shape,
+    double scaleX, double scaleY,
+    double translateX, double translateY,
+    double rangePixels,
+    const MsdfgenGeneratorConfig* config
+);
+
+/* ============================================================================
+ * Batch generation
+ * ============================================================================ */
+
+/*
+ * Generates count bitmaps on an internal work-stealing thread pool, most expensive
+ * items first. results must hold count entries, each to be released with
+ * msdfgen_bitmap_free. Shapes may be shared between items but must not be modified
+ * during the call. threadCount <= 0 uses msdfgen_get_thread_count() threads.
+ * Returns the number of successfully generated bitmaps.
+ */
+MSDFGEN_C_API int msdfgen_generate_batch(
+    const MsdfgenBatchItem* items,
+    int count,
+    MsdfgenBitmap* results,
+    int threadCount
+);
+
+/*
+ * Like msdfgen_generate_batch, but writes item i into the caller-owned buffer
+ * outputs[i] in the given pixel format, with rowStrides[i] bytes per row
+ * (rowStrides may be NULL for tightly packed rows). If results is not NULL,
+ * results[i] is set to 1 or 0. Returns the number of successfully generated items.
+ */
+MSDFGEN_C_API int msdfgen_generate_batch_into(
+    const MsdfgenBatchItem* items,
+    int count,
+    MsdfgenPixelFormat format,
+    void* const* outputs,
+    const int* rowStrides,
+    int* results,
+    int threadCount
+);
+
+/*
+ * Like msdfgen_generate_batch_into, but writes item i into views[i], which must be
+ * the item's size. The views may be disjoint windows of one shared atlas.
+ */
+MSDFGEN_C_API int msdfgen_generate_batch_view(
+    const MsdfgenBatchItem* items,
+    int count,
+    const MsdfgenBitmapView* views,
+    int* results,
+    int threadCount
+);
+
+/* ============================================================================
+ * Atlas generation
+ * ============================================================================ */
+
+MSDFGEN_C_API MsdfgenAtlasConfig msdfgen_atlas_config_default(void);
+
+/*
+ * Frames each shape from its bounds at config->scale, grown by half the range on
+ * every side, packs the rectangles into one atlas and generates all glyphs in
+ * parallel straight into their rectangles. Edge coloring is up to the caller.
+ * Release the result with msdfgen_atlas_free.
+ */
+MSDFGEN_C_API MsdfgenAtlas msdfgen_generate_atlas(
+    const MsdfgenShape* shapes,
+    int shapeCount,
+    const MsdfgenAtlasConfig* config
+);
+
+MSDFGEN_C_API void msdfgen_atlas_free(MsdfgenAtlas* atlas);
+
+/* ============================================================================
+ * Asynchronous jobs
+ * ============================================================================ */
+
+/*
+ * Limits the asynchronous job queue. Submission fails once maxJobs jobs are alive,
+ * counting queued, running and finished jobs until their handles are released,
+ * which bounds the memory held by results (<= 0 for no limit; the default is 256).
+ * At most threadCount jobs run at a time on background threads (<= 0 uses
+ * msdfgen_get_thread_count() at submission, the default).
+ */
+MSDFGEN_C_API void msdfgen_jobs_set_limits(int maxJobs, int threadCount);
+
+/*
+ * Queues the generation of one bitmap on a background thread and returns its job
+ * handle, or NULL if the job limit is reached. The shape is copied, so it may be
+ * changed or destroyed right after the call. callback, if not NULL, is called
+ * once with the final status: on the background thread when the job finishes,
+ * or on the cancelling thread. It must not block for long and may release the job.
+ * Every returned handle must be released with msdfgen_job_release.
+ */
+MSDFGEN_C_API MsdfgenJob msdfgen_job_submit(
+    const MsdfgenBatchItem* item,
+    MsdfgenJobCallback callback,
+    void* userData
+);
+
+/*
+ * Like msdfgen_job_submit, but generates into caller-owned storage in the given
+ * pixel format with rowStride bytes per row (0 for tightly packed rows). The
+ * storage must stay valid until the job is finished.
+ */
+MSDFGEN_C_API MsdfgenJob msdfgen_job_submit_into(
+    const MsdfgenBatchItem* item,
+    MsdfgenPixelFormat format,
+    void* output,
+    int rowStride,
+    MsdfgenJobCallback callback,
+    void* userData
+);
+
+/* Like msdfgen_job_submit_into with a view of the item's size, which is copied */
+MSDFGEN_C_API MsdfgenJob msdfgen_job_submit_view(
+    const MsdfgenBatchItem* item,
+    const MsdfgenBitmapView* view,
+    MsdfgenJobCallback callback,
+    void* userData
+);
+
+MSDFGEN_C_API MsdfgenJobStatus msdfgen_job_status(MsdfgenJob job);
+
+/* Waits until the job is finished or timeoutMilliseconds have passed (< 0 waits indefinitely) and returns its status */
+MSDFGEN_C_API MsdfgenJobStatus msdfgen_job_wait(MsdfgenJob job, int timeoutMilliseconds);
+
+/* Cancels a job that has not started yet. Returns 1 if it was cancelled; running jobs finish normally */
+MSDFGEN_C_API int msdfgen_job_cancel(MsdfgenJob job);
+
+/*
+ * Moves the bitmap out of a job submitted with msdfgen_job_submit that finished
+ * with MSDFGEN_JOB_DONE; the caller releases it with msdfgen_bitmap_free.
+ * Returns 0 if the job is not done or its result was already taken.
+ */
+MSDFGEN_C_API int msdfgen_job_take_result(MsdfgenJob job, MsdfgenBitmap* result);
+
+/* Drops the handle; a running job finishes in the background and an untaken result is freed */
+MSDFGEN_C_API void msdfgen_job_release(MsdfgenJob job);
+
+/* ============================================================================
+ * Result caches
+ * ============================================================================ */
+
+/*
+ * Opens or creates a memory-mapped cache file consulted by all generator entry
+ * points (replacing any open one). Results are keyed by a hash of the shape
+ * geometry and edge colors, the transformation, range, generator config, bitmap
+ * type and size. A cache written by a build with other msdfgen sources or other
+ * generators is discarded; once it grows past maxBytes, the least recently used
+ * entries are evicted.
+ * Returns 1 on success, and 0 without touching the file if it is not a cache.
+ */
+MSDFGEN_C_API int msdfgen_disk_cache_open(const char* path, unsigned long long maxBytes);
+MSDFGEN_C_API void msdfgen_disk_cache_close(void);
+MSDFGEN_C_API void msdfgen_disk_cache_clear(void);
+
+/*
+ * Keeps up to maxBytes of generated results in memory, under the same keys as the
+ * disk cache, which it is consulted before. A hit copies the stored field into the
+ * output. The least recently used results are dropped first; 0 disables the cache
+ * and frees it (the default). Region generation of partial fields is not cached.
+ */
+MSDFGEN_C_API void msdfgen_memory_cache_set_budget(unsigned long long maxBytes);
+
+/* Drops all cached results and zeroes the counters */
+MSDFGEN_C_API void msdfgen_memory_cache_clear(void);
+
+MSDFGEN_C_API int msdfgen_memory_cache_get_stats(MsdfgenMemoryCacheStats* stats);
+
+/* ============================================================================
+ * Distance acceleration
+ * ============================================================================ */
+
+/*
+ * Selects whether distance queries go through a bounding volume hierarchy over the
+ * edge bounds, which skips edges farther than the best distance found so far and
+ * gives the same result as evaluating every edge. Used for SDF generation without
+ * overlap support; the other modes combine perpendicular and per-contour distances
+ * that edge bounds cannot rule out, so they always evaluate every edge.
+ * The setting is process-wide; the default is MSDFGEN_ACCELERATION_AUTO.
+ */
+MSDFGEN_C_API void msdfgen_set_distance_acceleration(MsdfgenDistanceAcceleration mode);
+MSDFGEN_C_API MsdfgenDistanceAcceleration msdfgen_get_distance_acceleration(void);
+
+/* ============================================================================
+ * Distance precision
+ * ============================================================================ */
+
+/*
+ * Selects the precision of SDF, MSDF and MTSDF distances, float using SIMD pixel packets.
+ * In msdfgen-bench --verify, float fields decode within 1e-4 px of double ones at 128 px;
+ * near-tied edges can swap single MSDF channels. Process-wide, double by default.
+ */
+MSDFGEN_C_API void msdfgen_set_distance_precision(MsdfgenDistancePrecision precision);
+MSDFGEN_C_API MsdfgenDistancePrecision msdfgen_get_distance_precision(void);
+
+/* ============================================================================
+ * Band culling
+ * ============================================================================ */
+
+/*
+ * Selects whether double precision SDF generation fills blocks beyond rangePixels with 0 or 1,
+ * giving the ordinary field clamped to 0..1 unless contours intersect themselves or, with
+ * overlapSupport, overlap with opposite orientations. Process-wide, disabled by default.
+ */
+MSDFGEN_C_API void msdfgen_set_band_culling(MsdfgenBandCulling mode);
+MSDFGEN_C_API MsdfgenBandCulling msdfgen_get_band_culling(void);
+
+/* ============================================================================
+ * Scanline sign
+ * ============================================================================ */
+
+/*
+ * Selects whether pixels are signed by fillRule, like msdfgen's scanline pass, in place of
+ * overlapSupport. Process-wide, disabled by default.
+ */
+MSDFGEN_C_API void msdfgen_set_scanline_sign(int enabled, MsdfgenFillRule fillRule);
+
+/* Returns whether the scanline sign is enabled; fillRule, if not NULL, receives its fill rule */
+MSDFGEN_C_API int msdfgen_get_scanline_sign(MsdfgenFillRule* fillRule);
+
+/* ============================================================================
+ * Threading
+ * ============================================================================ */
+
+/*
+ * Sets the process-wide thread budget, 0 for all hardware threads (the default).
+ * It is the default thread count of batch and atlas generation and bitmap
+ * conversion, and, in builds with parallel generation, the number of threads a
+ * single large generator call may use to compute rows and error correction.
+ * Generator calls made concurrently share the budget, and calls made from batch
+ * tasks run on one thread, so callers driving their own thread pools are not
+ * oversubscribed; such callers may also set the budget to 1.
+ */
+MSDFGEN_C_API void msdfgen_set_thread_count(int threadCount);
+
+/* Returns the effective thread budget, at least 1 */
+MSDFGEN_C_API int msdfgen_get_thread_count(void);
+
+/* ============================================================================
+ * Instrumentation
+ * ============================================================================ */
+
+/*
+ * Enables or disables the instrumentation counters, which are off by default.
+ * Each thread counts into its own counters; msdfgen_stats_get sums them. While
+ * disabled, the library only checks a flag at each instrumented stage.
+ */
+MSDFGEN_C_API void msdfgen_stats_enable(int enabled);
+
+/* Fills stats with the totals since the last reset. Returns 1 if counting is enabled */
+MSDFGEN_C_API int msdfgen_stats_get(MsdfgenStats* stats);
+
+/* Restarts all counters from zero */
+MSDFGEN_C_API void msdfgen_stats_reset(void);
+
 /* ============================================================================
  * Bitmap operations
  * ============================================================================ */
@@ -263,6 +916,43 @@ MSDFGEN_C_API void msdfgen_bitmap_to_bytes(
     unsigned char edgeValue
 );
 
+/*
+ * Same mapping as msdfgen_bitmap_to_bytes with outputChannels (1-4) bytes per pixel:
+ * the first channels are converted, channels missing from the bitmap are set to 255.
+ * Vectorized for the host CPU and multithreaded for large bitmaps.
+ */
+MSDFGEN_C_API void msdfgen_bitmap_to_bytes_ex(
+    const MsdfgenBitmap* bitmap,
+    unsigned char* output,
+    int outputChannels,
+    unsigned char edgeValue
+);
+
+/*
+ * Converts a MSDFGEN_PIXEL_FLOAT32 view into a MSDFGEN_PIXEL_UINT8 view of the same
+ * size, mapping channels as msdfgen_bitmap_to_bytes_ex does with output->channels
+ * (1-4). Rows are matched by their position in the image, so views of opposite
+ * row order are flipped. Returns 1 on success.
+ */
+MSDFGEN_C_API int msdfgen_bitmap_to_bytes_view(
+    const MsdfgenBitmapView* bitmap,
+    const MsdfgenBitmapView* output,
+    unsigned char edgeValue
+);
+
+/* View of a bitmap's float pixels, or a view with NULL pixels if bitmap is NULL */
+MSDFGEN_C_API MsdfgenBitmapView msdfgen_bitmap_get_view(const MsdfgenBitmap* bitmap);
+
+/*
+ * The width x height window at x, y of a view, with y counted in the view's row
+ * order. Returns a view with NULL pixels if the window does not fit in the view.
+ */
+MSDFGEN_C_API MsdfgenBitmapView msdfgen_bitmap_view_window(
+    const MsdfgenBitmapView* view,
+    int x, int y,
+    int width, int height
+);
+
 /* ============================================================================
  * Geometry resolution (requires Skia)
  * ============================================================================ */
@@ -286,8 +976,28 @@ MSDFGEN_C_API void msdfgen_freetype_deinit(MsdfgenFreetype freetype);
 
 MSDFGEN_C_API MsdfgenFont msdfgen_font_load(MsdfgenFreetype freetype, const char* filename);
 MSDFGEN_C_API MsdfgenFont msdfgen_font_load_data(MsdfgenFreetype freetype, const unsigned char* data, int length);
+
+/*
+ * Loads a font whose glyphs may be loaded from several threads at once with
+ * msdfgen_font_load_glyph and msdfgen_font_load_glyph_by_index. The file is memory
+ * mapped once and shared by a pool of FreeType faces, one per concurrently loading
+ * thread, so loads do not serialize on a lock. All other font functions, including
+ * setting variation axes and the glyph cache budget, must not run concurrently
+ * with anything else on the font.
+ */
+MSDFGEN_C_API MsdfgenFont msdfgen_font_load_concurrent(MsdfgenFreetype freetype, const char* filename);
+
 MSDFGEN_C_API void msdfgen_font_destroy(MsdfgenFont font);
 
+/*
+ * Keeps decoded glyph outlines and advances of the font in memory, keyed by glyph
+ * index and coordinate scaling, so that loading a glyph again copies the outline
+ * into the shape without decoding it. The least recently used glyphs are dropped
+ * once the cache would exceed maxBytes; 0 disables the cache and frees it (the
+ * default). Setting a variation axis empties the cache. Returns 1 on success.
+ */
+MSDFGEN_C_API int msdfgen_font_set_glyph_cache(MsdfgenFont font, unsigned long long maxBytes);
+
 MSDFGEN_C_API int msdfgen_font_get_metrics(MsdfgenFont font, MsdfgenFontMetrics* metrics, MsdfgenFontCoordinateScaling scaling);
 MSDFGEN_C_API int msdfgen_font_get_whitespace_width(MsdfgenFont font, double* spaceAdvance, double* tabAdvance, MsdfgenFontCoordinateScaling scaling);
 MSDFGEN_C_API int msdfgen_font_get_glyph_count(MsdfgenFont font, unsigned int* count);
@@ -325,6 +1035,24 @@ MSDFGEN_C_API int msdfgen_font_get_kerning_by_index(
     double* kerning
 );
 
+/*
+ * Reads the advances of glyphCount glyphs and all non-zero kerning pairs among them
+ * in one call. advances receives glyphCount values and may be NULL. Kerning values
+ * equal those of msdfgen_font_get_kerning_by_index but are read straight from the
+ * font's kerning table, sorted by glyphIndex0, then glyphIndex1. On input pairCount
+ * holds the capacity of pairs, on output the number of pairs; pass NULL pairs to
+ * only query the count. Returns 0 on failure or if pairs is too small.
+ */
+MSDFGEN_C_API int msdfgen_font_get_kerning_table(
+    MsdfgenFont font,
+    const unsigned int* glyphIndices,
+    int glyphCount,
+    MsdfgenFontCoordinateScaling scaling,
+    double* advances,
+    MsdfgenKerningPair* pairs,
+    int* pairCount
+);
+
 /* Variable font support */
 MSDFGEN_C_API int msdfgen_font_set_variation_axis(
     MsdfgenFreetype freetype,
@@ -346,6 +1074,51 @@ MSDFGEN_C_API int msdfgen_font_get_variation_axis(
     MsdfgenFontVariationAxis* axis
 );
 
+/*
+ * Sets *axes to the font's variation axes and *count to their number. The array and
+ * the axis names are read from FreeType once and owned by the font until it is
+ * destroyed.
+ */
+MSDFGEN_C_API int msdfgen_font_get_variation_axes(
+    MsdfgenFreetype freetype,
+    MsdfgenFont font,
+    const MsdfgenFontVariationAxis** axes,
+    int* count
+);
+
+/* Sets the design coordinates of all count axes at once, in the order of msdfgen_font_get_variation_axes */
+MSDFGEN_C_API int msdfgen_font_set_variation_coordinates(
+    MsdfgenFreetype freetype,
+    MsdfgenFont font,
+    const double* coordinates,
+    int count
+);
+
+/*
+ * Generates one atlas of the given glyphs per variation instance, as with
+ * msdfgen_generate_atlas. coordinates holds instanceCount rows of design
+ * coordinates for all axes, in the order of msdfgen_font_get_variation_axes.
+ * The variation state is set once per instance, then every glyph is loaded,
+ * normalized and, for MSDF and MTSDF, colored with simple edge coloring at
+ * angleThreshold. atlases receives instanceCount atlases, each to be released
+ * with msdfgen_atlas_free; failed instances have success 0. advances, if not
+ * NULL, receives instanceCount rows of glyphCount advances. The font's previous
+ * coordinates are restored afterwards. Returns the number of generated atlases.
+ */
+MSDFGEN_C_API int msdfgen_font_generate_instance_atlases(
+    MsdfgenFreetype freetype,
+    MsdfgenFont font,
+    const unsigned int* glyphIndices,
+    int glyphCount,
+    MsdfgenFontCoordinateScaling scaling,
+    const double* coordinates,
+    int instanceCount,
+    double angleThreshold,
+    const MsdfgenAtlasConfig* config,
+    MsdfgenAtlas* atlases,
+    double* advances
+);
+
 /* ============================================================================
  * Utility functions
  * ============================================================================ */
@@ -368,6 +1141,9 @@ MSDFGEN_C_API int msdfgen_has_skia_support(void);
 /* Check if extension support (FreeType, PNG, SVG) is available */
 MSDFGEN_C_API int msdfgen_has_extension_support(void);
 
+/* Check if single generator calls run on several threads (MSDFGEN_USE_OPENMP) */
+MSDFGEN_C_API int msdfgen_has_parallel_generation(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,139 @@
+/*
+ * Internal rectangle packer implementation
+ */
+
+#include "msdfgen_c_atlas_packer.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace msdfgen_c {
+
+#define MSDFGEN_C_MAX_ATLAS_SIZE 32768
+
+SkylinePacker::SkylinePacker(int width, int height) : width(width), height(height) {
+    Segment initial = {0, 0, width};
+    skyline.push_back(initial);
+}
+
+bool SkylinePacker::insert(int rectWidth, int rectHeight, int& x, int& y) {
+    int bestTop = INT_MAX;
+    int bestX = INT_MAX;
+    size_t bestIndex = 0;
+    for (size_t i = 0; i < skyline.size(); i++) {
+        int fitY = fitAt(i, rectWidth, rectHeight);
+        if (fitY >= 0 && (fitY + rectHeight < bestTop || (fitY + rectHeight == bestTop && skyline[i].x < bestX))) {
+            bestTop = fitY + rectHeight;
+            bestX = skyline[i].x;
+            bestIndex = i;
+        }
+    }
+    if (bestTop == INT_MAX) return false;
+    x = bestX;
+    y = bestTop - rectHeight;
+    place(bestIndex, x, y, rectWidth, rectHeight);
+    return true;
+}
+
+/* Returns the lowest y at which the rectangle can rest with its left edge on segment index, or -1 */
+int SkylinePacker::fitAt(size_t index, int rectWidth, int rectHeight) const {
+    int x = skyline[index].x;
+    if (x + rectWidth > width) return -1;
+    int y = 0;
+    int widthLeft = rectWidth;
+    for (size_t i = index; widthLeft > 0 && i < skyline.size(); i++) {
+        y = std::max(y, skyline[i].y);
+        if (y + rectHeight > height) return -1;
+        widthLeft -= skyline[i].width;
+    }
+    return y;
+}
+
+void SkylinePacker::place(size_t index, int x, int y, int rectWidth, int rectHeight) {
+    Segment segment = {x, y + rectHeight, rectWidth};
+    skyline.insert(skyline.begin() + index, segment);
+
+    // Trim or remove the segments now covered by the new one
+    for (size_t i = index + 1; i < skyline.size();) {
+        int coveredEnd = skyline[i - 1].x + skyline[i - 1].width;
+        if (skyline[i].x >= coveredEnd) break;
+        int shrink = coveredEnd - skyline[i].x;
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+        if (skyline[i].width > 0) break;
+        skyline.erase(skyline.begin() + i);
+    }
+
+    // Merge neighbors at the same height
+    for (size_t i = 0; i + 1 < skyline.size();) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        } else {
+            i++;
+        }
+    }
+}
+
+static bool packInto(const std::vector<int>& order, const int* widths, const int* heights, int spacing, int atlasWidth, int atlasHeight, int* outX, int* outY) {
+    // Every rectangle reserves spacing pixels to its right and top, so the bin is enlarged by the same amount
+    SkylinePacker packer(atlasWidth + spacing, atlasHeight + spacing);
+    for (int index : order) {
+        if (widths[index] <= 0 || heights[index] <= 0) {
+            outX[index] = 0;
+            outY[index] = 0;
+            continue;
+        }
+        if (!packer.insert(widths[index] + spacing, heights[index] + spacing, outX[index], outY[index])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool packRectangles(const int* widths, const int* heights, int count, int spacing, int& atlasWidth, int& atlasHeight, int* outX, int* outY) {
+    spacing = std::max(spacing, 0);
+
+    std::vector<int> order;
+    order.reserve(count);
+    double area = 0;
+    int maxWidth = 1, maxHeight = 1;
+    for (int i = 0; i < count; i++) {
+        order.push_back(i);
+        if (widths[i] > 0 && heights[i] > 0) {
+            area += static_cast<double>(widths[i] + spacing) * (heights[i] + spacing);
+            maxWidth = std::max(maxWidth, widths[i]);
+            maxHeight = std::max(maxHeight, heights[i]);
+        }
+    }
+    // Tall rectangles first, which suits the skyline heuristic
+    std::stable_sort(order.begin(), order.end(), [widths, heights](int a, int b) {
+        return heights[a] != heights[b] ? heights[a] > heights[b] : widths[a] > widths[b];
+    });
+
+    if (atlasWidth > 0 && atlasHeight > 0) {
+        return packInto(order, widths, heights, spacing, atlasWidth, atlasHeight, outX, outY);
+    }
+
+    // Candidate sizes in order of increasing area: s x s, 2s x s, 2s x 2s, ...
+    int side = 1;
+    while (side < MSDFGEN_C_MAX_ATLAS_SIZE && (2.0 * side * side < area || side < maxWidth || side < maxHeight)) {
+        side <<= 1;
+    }
+    for (; side <= MSDFGEN_C_MAX_ATLAS_SIZE; side <<= 1) {
+        if (static_cast<double>(side) * side >= area && packInto(order, widths, heights, spacing, side, side, outX, outY)) {
+            atlasWidth = side;
+            atlasHeight = side;
+            return true;
+        }
+        if (side < MSDFGEN_C_MAX_ATLAS_SIZE && packInto(order, widths, heights, spacing, side << 1, side, outX, outY)) {
+            atlasWidth = side << 1;
+            atlasHeight = side;
+            return true;
+        }
+    }
+    return false;
+}
+
+}
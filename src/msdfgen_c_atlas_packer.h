@@ -0,0 +1,49 @@
+/*
+ * Internal rectangle packer used by atlas generation
+ */
+
+#ifndef MSDFGEN_C_ATLAS_PACKER_H
+#define MSDFGEN_C_ATLAS_PACKER_H
+
+#include <cstddef>
+#include <vector>
+
+namespace msdfgen_c {
+
+/*
+ * Skyline bottom-left packer. Keeps the upper contour of the placed rectangles
+ * as a list of horizontal segments and puts each new rectangle where its top
+ * edge ends up lowest.
+ */
+class SkylinePacker {
+
+public:
+    SkylinePacker(int width, int height);
+
+    /* Finds room for a width x height rectangle; returns false if it does not fit */
+    bool insert(int width, int height, int& x, int& y);
+
+private:
+    struct Segment {
+        int x, y, width;
+    };
+
+    std::vector<Segment> skyline;
+    int width, height;
+
+    int fitAt(size_t index, int rectWidth, int rectHeight) const;
+    void place(size_t index, int x, int y, int rectWidth, int rectHeight);
+
+};
+
+/*
+ * Packs count rectangles, separated by spacing pixels, into an atlas of
+ * atlasWidth x atlasHeight. If either dimension is not positive, the smallest
+ * power-of-two atlas that fits everything is chosen and written back.
+ * Returns false if the rectangles do not fit.
+ */
+bool packRectangles(const int* widths, const int* heights, int count, int spacing, int& atlasWidth, int& atlasHeight, int* outX, int* outY);
+
+}
+
+#endif /* MSDFGEN_C_ATLAS_PACKER_H */
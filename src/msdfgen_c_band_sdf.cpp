@@ -0,0 +1,313 @@
+/*
+ * Internal coarse-to-fine SDF generation that only evaluates pixels near the outline
+ *
+ * Distances are computed the way msdfgen's ShapeDistanceFinder computes them with a
+ * TrueDistanceSelector and a SimpleContourCombiner or OverlappingContourCombiner:
+ * with the same segment distances, edge visiting order, edge cache and combination
+ * of the contours, so that the evaluated pixels match msdfgen::generateSDF.
+ */
+
+#include "msdfgen_c_band_sdf.h"
+#include "msdfgen_c_distance_finder.h"
+#include "msdfgen_c_edge_bvh.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace msdfgen;
+
+namespace msdfgen_c {
+
+/* Side in pixels of the blocks the field is first divided into */
+#define MSDFGEN_C_BAND_TILE 32
+
+/* Side in pixels of the smallest blocks, whose pixels are evaluated if the block cannot be filled */
+#define MSDFGEN_C_BAND_LEAF 4
+
+/* Field values of the two sides of the outline beyond the range, and the distances where they begin */
+struct BandLimits {
+    double lowDistance, highDistance;
+    float lowValue, highValue;
+    float minValue, maxValue;   /* The range of values written, unbounded without a proper range */
+    double margin;
+};
+
+/* A square block of pixels, in generator rows (before the Y axis is inverted) */
+struct BandBlock {
+    int x, y;
+    int size;
+};
+
+/* Bounds of an edge */
+struct BandBox {
+    double l, b, r, t;
+};
+
+/* msdfgen's TrueDistanceSelector at one point */
+struct BandSelector {
+    typedef double Distance;
+    SignedDistance minDistance;
+
+    void merge(const BandSelector& other) {
+        if (other.minDistance < minDistance) {
+            minDistance = other.minDistance;
+        }
+    }
+
+    double distance() const {
+        return minDistance.distance;
+    }
+
+    static double resolve(double distance) {
+        return distance;
+    }
+};
+
+/*
+ * The distance finder of one thread. It keeps a copy of msdfgen's edge cache, which
+ * only skips edges that cannot be as near as the nearest one found so far, and
+ * visits the edges of each contour from the last one on, so ties resolve alike.
+ */
+class BandDistanceFinder {
+
+public:
+    BandDistanceFinder(const Shape& shape, bool overlapSupport, const EdgeBvh* bvh) : evaluations(0), overlapSupport(overlapSupport), bvh(bvh), hint(-1) {
+        for (const Contour& contour : shape.contours) {
+            for (size_t i = 0; i < contour.edges.size(); i++) {
+                CachedEdge edge;
+                edge.segment = visitedEdge(contour, i);
+                edge.point = Point2();
+                edge.absDistance = 0;
+                edges.push_back(edge);
+                BandBox box = {DBL_MAX, DBL_MAX, -DBL_MAX, -DBL_MAX};
+                edge.segment->bound(box.l, box.b, box.r, box.t);
+                boxes.push_back(box);
+            }
+            contourEnds.push_back(static_cast<int>(edges.size()));
+            windings.push_back(contour.winding());
+        }
+        contourSelectors.resize(contourEnds.size());
+        contourDistances.resize(contourEnds.size());
+    }
+
+    /* The generator's distance at p; nearest receives the absolute distance to the nearest edge */
+    double distance(Point2 p, double& nearest) {
+        if (bvh) {
+            SignedDistance best = bvh->distance(p, hint, evaluations);
+            nearest = fabs(best.distance);
+            return best.distance;
+        }
+        SignedDistance shapeDistance;
+        int first = 0;
+        for (size_t i = 0; i < contourEnds.size(); i++) {
+            SignedDistance& contourDistance = contourSelectors[i].minDistance;
+            contourDistance = SignedDistance();
+            // Without overlap support, msdfgen shares one edge selector among all contours
+            const SignedDistance& selected = overlapSupport ? contourDistance : shapeDistance;
+            for (int j = first; j < contourEnds[i]; j++) {
+                CachedEdge& edge = edges[j];
+                double delta = MSDFGEN_C_DISTANCE_DELTA_FACTOR * (p - edge.point).length();
+                if (edge.absDistance - delta <= fabs(selected.distance)) {
+                    double param;
+                    SignedDistance distance = edge.segment->signedDistance(p, param);
+                    evaluations++;
+                    if (distance < contourDistance) {
+                        contourDistance = distance;
+                    }
+                    if (distance < shapeDistance) {
+                        shapeDistance = distance;
+                    }
+                    edge.point = p;
+                    edge.absDistance = fabs(distance.distance);
+                }
+            }
+            first = contourEnds[i];
+        }
+        nearest = fabs(shapeDistance.distance);
+        if (overlapSupport) {
+            return combineOverlapping(contourSelectors.data(), windings.data(), static_cast<int>(contourSelectors.size()), contourDistances.data());
+        }
+        return shapeDistance.distance;
+    }
+
+    /*
+     * Whether the contours with an edge within reach of p are all on the same side of p,
+     * each by the sign of its own nearest edge. Only edges whose bounds are within reach
+     * are evaluated.
+     */
+    bool sameSide(Point2 p, double reach) {
+        double reachSquared = reach * reach;
+        int side = 0;
+        int first = 0;
+        for (size_t i = 0; i < contourEnds.size(); i++) {
+            SignedDistance contourDistance;
+            for (int j = first; j < contourEnds[i]; j++) {
+                const BandBox& box = boxes[j];
+                double dx = std::max(std::max(box.l - p.x, p.x - box.r), 0.0);
+                double dy = std::max(std::max(box.b - p.y, p.y - box.t), 0.0);
+                if (dx * dx + dy * dy > reachSquared) continue;
+                double param;
+                SignedDistance distance = edges[j].segment->signedDistance(p, param);
+                evaluations++;
+                if (distance < contourDistance) {
+                    contourDistance = distance;
+                }
+            }
+            first = contourEnds[i];
+            if (fabs(contourDistance.distance) <= reach) {
+                int contourSide = contourDistance.distance < 0 ? -1 : 1;
+                if (side && contourSide != side) {
+                    return false;
+                }
+                side = contourSide;
+            }
+        }
+        return true;
+    }
+
+    unsigned long long evaluations;
+
+private:
+    struct CachedEdge {
+        const EdgeSegment* segment;
+        Point2 point;
+        double absDistance;
+    };
+
+    std::vector<CachedEdge> edges;
+    std::vector<BandBox> boxes;
+    std::vector<int> contourEnds;
+    std::vector<int> windings;
+    std::vector<BandSelector> contourSelectors;
+    std::vector<double> contourDistances;
+    bool overlapSupport;
+    const EdgeBvh* bvh;
+    int hint;
+
+};
+
+static void fillBlock(const BitmapRef<float, 1>& output, bool inverseYAxis, int left, int bottom, int right, int top, float value) {
+    for (int y = bottom; y < top; y++) {
+        int row = inverseYAxis ? output.height - y - 1 : y;
+        std::fill(output(left, row), output(right, row), value);
+    }
+}
+
+/*
+ * Fills the block if the distance at its center proves that all of its pixels lie
+ * beyond the range on the same side. Blocks whose pixels are all farther from the
+ * center than its nearest edge contain no edge, so no contour crosses them. Without
+ * overlap support, the sign of a pixel is that of its nearest edge, which belongs to
+ * a contour within the nearest distance plus twice the block's radius of the center;
+ * the block is only filled if all of those contours have it on the same side.
+ */
+static bool fillIfBeyondRange(const BitmapRef<float, 1>& output, bool inverseYAxis, int left, int bottom, int right, int top, const SDFTransformation& transformation, const BandLimits& limits, bool overlapSupport, BandDistanceFinder& finder) {
+    Point2 center = transformation.unproject(Point2(.5 * (left + right), .5 * (bottom + top)));
+    double radius = transformation.unprojectVector(Vector2(.5 * (right - left - 1), .5 * (top - bottom - 1))).length();
+    double nearest;
+    double distance = finder.distance(center, nearest);
+    double slack = limits.margin + 1e-9 * nearest;
+    double bound = nearest - radius - slack;
+    float value;
+    if (distance > 0 && bound >= limits.highDistance) {
+        value = limits.highValue;
+    } else if (distance < 0 && -bound <= limits.lowDistance) {
+        value = limits.lowValue;
+    } else {
+        return false;
+    }
+    if (!overlapSupport && !finder.sameSide(center, nearest + 2 * radius + slack)) {
+        return false;
+    }
+    fillBlock(output, inverseYAxis, left, bottom, right, top, value);
+    return true;
+}
+
+unsigned long long generateSDFBanded(const BitmapRef<float, 1>& output, const Shape& shape, const SDFTransformation& transformation, bool overlapSupport, bool accelerated) {
+    std::unique_ptr<EdgeBvh> bvh;
+    if (accelerated && !overlapSupport) {
+        bvh.reset(new EdgeBvh(shape));
+    }
+
+    // The distances at which the field reaches 0 and 1; without a proper range, nothing is filled
+    BandLimits limits = {-DBL_MAX, DBL_MAX, 0.0f, 1.0f, -FLT_MAX, FLT_MAX, 0.0};
+    DistanceMapping inverse = transformation.distanceMapping.inverse();
+    double zeroDistance = inverse(0.0), oneDistance = inverse(1.0);
+    if (std::isfinite(zeroDistance) && std::isfinite(oneDistance) && zeroDistance != oneDistance) {
+        bool ascending = zeroDistance < oneDistance;
+        limits.lowDistance = std::min(zeroDistance, oneDistance);
+        limits.highDistance = std::max(zeroDistance, oneDistance);
+        limits.lowValue = ascending ? 0.0f : 1.0f;
+        limits.highValue = ascending ? 1.0f : 0.0f;
+        limits.minValue = 0.0f;
+        limits.maxValue = 1.0f;
+    }
+    // Segment distances and the inverse mapping are both subject to rounding; blocks are
+    // only filled beyond this slack so that no pixel whose value is inside (0, 1) is filled
+    double l = DBL_MAX, b = DBL_MAX, r = -DBL_MAX, t = -DBL_MAX;
+    shape.bound(l, b, r, t);
+    double extent = l <= r ? std::max(std::max(fabs(l), fabs(r)), std::max(fabs(b), fabs(t))) : 0.0;
+    if (limits.highDistance < DBL_MAX) {
+        limits.margin = 1e-9 * (1.0 + extent + std::max(fabs(limits.lowDistance), fabs(limits.highDistance)));
+    }
+
+    bool inverseYAxis = shape.getYAxisOrientation() == Y_DOWNWARD;
+    int tileColumns = (output.width + MSDFGEN_C_BAND_TILE - 1) / MSDFGEN_C_BAND_TILE;
+    int tileCount = tileColumns * ((output.height + MSDFGEN_C_BAND_TILE - 1) / MSDFGEN_C_BAND_TILE);
+    unsigned long long evaluations = 0;
+#ifdef MSDFGEN_USE_OPENMP
+    #pragma omp parallel reduction(+:evaluations)
+#endif
+    {
+        BandDistanceFinder finder(shape, overlapSupport, bvh.get());
+        std::vector<BandBlock> blocks;
+#ifdef MSDFGEN_USE_OPENMP
+        #pragma omp for schedule(dynamic)
+#endif
+        for (int tile = 0; tile < tileCount; tile++) {
+            BandBlock first = {tile % tileColumns * MSDFGEN_C_BAND_TILE, tile / tileColumns * MSDFGEN_C_BAND_TILE, MSDFGEN_C_BAND_TILE};
+            blocks.push_back(first);
+            while (!blocks.empty()) {
+                BandBlock block = blocks.back();
+                blocks.pop_back();
+                int right = std::min(block.x + block.size, output.width);
+                int top = std::min(block.y + block.size, output.height);
+                if (fillIfBeyondRange(output, inverseYAxis, block.x, block.y, right, top, transformation, limits, overlapSupport, finder)) {
+                    continue;
+                }
+                if (block.size > MSDFGEN_C_BAND_LEAF) {
+                    // Quadrants are pushed in reverse so that they are refined in row order
+                    int half = block.size / 2;
+                    for (int i = 3; i >= 0; i--) {
+                        BandBlock quadrant = {block.x + (i & 1) * half, block.y + (i >> 1) * half, half};
+                        if (quadrant.x < right && quadrant.y < top) {
+                            blocks.push_back(quadrant);
+                        }
+                    }
+                    continue;
+                }
+                // The pixels of the block are visited in alternating directions, which keeps the edge cache effective;
+                // their values are clamped like the filled blocks next to them
+                bool rightToLeft = false;
+                for (int y = block.y; y < top; y++) {
+                    int row = inverseYAxis ? output.height - y - 1 : y;
+                    for (int col = block.x; col < right; col++) {
+                        int x = rightToLeft ? right - 1 - (col - block.x) : col;
+                        double nearest;
+                        double distance = finder.distance(transformation.unproject(Point2(x + .5, y + .5)), nearest);
+                        float value = float(transformation.distanceMapping(distance));
+                        *output(x, row) = std::min(std::max(value, limits.minValue), limits.maxValue);
+                    }
+                    rightToLeft = !rightToLeft;
+                }
+            }
+        }
+        evaluations += finder.evaluations;
+    }
+    return evaluations;
+}
+
+}
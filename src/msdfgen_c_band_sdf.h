@@ -0,0 +1,33 @@
+/*
+ * Internal coarse-to-fine SDF generation that only evaluates pixels near the outline
+ */
+
+#ifndef MSDFGEN_C_BAND_SDF_H
+#define MSDFGEN_C_BAND_SDF_H
+
+#include "msdfgen.h"
+
+namespace msdfgen_c {
+
+/*
+ * Generates a true distance SDF like msdfgen::generateSDF, evaluating the shape only
+ * near the band of field values between 0 and 1. Square blocks of pixels are visited
+ * coarse to fine: the distance to the nearest edge at a block's center bounds the
+ * distance of each of its pixels, and a block that lies entirely beyond the range on
+ * one side of the outline is filled with 0 or 1, the value the field clamps to there.
+ * That side is the sign of the generator's own distance at the block's center.
+ * Without overlap support, a block is only filled if every contour that may hold
+ * the nearest edge of one of its pixels has the center on that side; with it, the
+ * side follows the combination of overlapping contours. Either way it is the sign
+ * of every pixel of the block unless a contour intersects itself, or with overlap
+ * support, contours of opposite orientations overlap.
+ * The remaining blocks are split down to a few pixels, whose values are exactly
+ * those of msdfgen::generateSDF, or without overlap support and with accelerated
+ * set, those of generateSDFAccelerated, clamped to the range of 0 to 1.
+ * Returns the number of edge distances computed.
+ */
+unsigned long long generateSDFBanded(const msdfgen::BitmapRef<float, 1>& output, const msdfgen::Shape& shape, const msdfgen::SDFTransformation& transformation, bool overlapSupport, bool accelerated);
+
+}
+
+#endif /* MSDFGEN_C_BAND_SDF_H */
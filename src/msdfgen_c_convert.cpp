@@ -0,0 +1,304 @@
+/*
+ * Internal float pixel conversion
+ *
+ * Every kernel evaluates exactly the same sequence of single-precision operations
+ * as the scalar path (clamp, both halves of the piecewise mapping, select, +0.5,
+ * truncate), so all instruction sets produce identical bytes. This file is built
+ * without floating-point contraction to keep it that way on FMA-capable targets.
+ */
+
+#include "msdfgen_c_convert.h"
+#include "msdfgen_c_cpu.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace msdfgen_c {
+
+typedef void (*ConvertKernel)(const float* src, unsigned char* dst, size_t count, unsigned char edgeValue);
+typedef void (*HalfKernel)(const float* src, unsigned short* dst, size_t count);
+
+static inline unsigned char convertValue(float val, unsigned char edgeValue) {
+    val = std::max(0.0f, std::min(1.0f, val));
+    float scaled;
+    if (val <= 0.5f) {
+        scaled = val * 2.0f * edgeValue;
+    } else {
+        scaled = edgeValue + (val - 0.5f) * 2.0f * (255 - edgeValue);
+    }
+    return static_cast<unsigned char>(scaled + 0.5f);
+}
+
+static void convertScalar(const float* src, unsigned char* dst, size_t count, unsigned char edgeValue) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = convertValue(src[i], edgeValue);
+    }
+}
+
+static inline unsigned short floatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = bits >> 16 & 0x8000u;
+    uint32_t magnitude = bits & 0x7fffffffu;
+    if (magnitude >= 0x7f800000u) {
+        // Infinity stays infinity, NaN stays a quiet NaN with the top payload bits kept
+        return static_cast<unsigned short>(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x0200u | (magnitude >> 13 & 0x03ffu) : 0u));
+    }
+    if (magnitude >= 0x477ff000u) {
+        // At or above the midpoint between 65504 and 65536
+        return static_cast<unsigned short>(sign | 0x7c00u);
+    }
+    uint32_t result, remainder, halfway;
+    if (magnitude < 0x38800000u) {
+        // Subnormal half; at most 2^-25 rounds to zero
+        if (magnitude <= 0x33000000u) {
+            return static_cast<unsigned short>(sign);
+        }
+        uint32_t mantissa = (magnitude & 0x007fffffu) | 0x00800000u;
+        int shift = 126 - static_cast<int>(magnitude >> 23);
+        result = mantissa >> shift;
+        remainder = mantissa & ((1u << shift) - 1u);
+        halfway = 1u << (shift - 1);
+    } else {
+        result = (magnitude - 0x38000000u) >> 13;
+        remainder = magnitude & 0x1fffu;
+        halfway = 0x1000u;
+    }
+    if (remainder > halfway || (remainder == halfway && (result & 1u))) {
+        ++result;
+    }
+    return static_cast<unsigned short>(sign | result);
+}
+
+static void convertHalfScalar(const float* src, unsigned short* dst, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = floatToHalf(src[i]);
+    }
+}
+
+#ifdef MSDFGEN_C_X86
+
+// min(x, 1) returns its second operand for NaN, matching std::min(1.0f, x)
+
+MSDFGEN_C_TARGET("sse4.1")
+static inline __m128i convertSse41(__m128 x, __m128 edge, __m128 upper) {
+    const __m128 zero = _mm_setzero_ps(), half = _mm_set1_ps(0.5f), one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f);
+    __m128 v = _mm_max_ps(_mm_min_ps(x, one), zero);
+    __m128 low = _mm_mul_ps(_mm_mul_ps(v, two), edge);
+    __m128 high = _mm_add_ps(edge, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(v, half), two), upper));
+    __m128 scaled = _mm_blendv_ps(high, low, _mm_cmple_ps(v, half));
+    return _mm_cvttps_epi32(_mm_add_ps(scaled, half));
+}
+
+MSDFGEN_C_TARGET("sse4.1")
+static void convertKernelSse41(const float* src, unsigned char* dst, size_t count, unsigned char edgeValue) {
+    const __m128 edge = _mm_set1_ps(static_cast<float>(edgeValue));
+    const __m128 upper = _mm_set1_ps(static_cast<float>(255 - edgeValue));
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = convertSse41(_mm_loadu_ps(src + i), edge, upper);
+        __m128i b = convertSse41(_mm_loadu_ps(src + i + 4), edge, upper);
+        __m128i c = convertSse41(_mm_loadu_ps(src + i + 8), edge, upper);
+        __m128i d = convertSse41(_mm_loadu_ps(src + i + 12), edge, upper);
+        __m128i bytes = _mm_packus_epi16(_mm_packus_epi32(a, b), _mm_packus_epi32(c, d));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+    }
+    convertScalar(src + i, dst + i, count - i, edgeValue);
+}
+
+MSDFGEN_C_TARGET("avx2")
+static inline __m256i convertAvx2(__m256 x, __m256 edge, __m256 upper) {
+    const __m256 zero = _mm256_setzero_ps(), half = _mm256_set1_ps(0.5f), one = _mm256_set1_ps(1.0f), two = _mm256_set1_ps(2.0f);
+    __m256 v = _mm256_max_ps(_mm256_min_ps(x, one), zero);
+    __m256 low = _mm256_mul_ps(_mm256_mul_ps(v, two), edge);
+    __m256 high = _mm256_add_ps(edge, _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(v, half), two), upper));
+    __m256 scaled = _mm256_blendv_ps(high, low, _mm256_cmp_ps(v, half, _CMP_LE_OQ));
+    return _mm256_cvttps_epi32(_mm256_add_ps(scaled, half));
+}
+
+MSDFGEN_C_TARGET("avx2")
+static void convertKernelAvx2(const float* src, unsigned char* dst, size_t count, unsigned char edgeValue) {
+    const __m256 edge = _mm256_set1_ps(static_cast<float>(edgeValue));
+    const __m256 upper = _mm256_set1_ps(static_cast<float>(255 - edgeValue));
+    // Packing works within 128-bit lanes, this restores the element order afterwards
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = convertAvx2(_mm256_loadu_ps(src + i), edge, upper);
+        __m256i b = convertAvx2(_mm256_loadu_ps(src + i + 8), edge, upper);
+        __m256i c = convertAvx2(_mm256_loadu_ps(src + i + 16), edge, upper);
+        __m256i d = convertAvx2(_mm256_loadu_ps(src + i + 24), edge, upper);
+        __m256i bytes = _mm256_packus_epi16(_mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permutevar8x32_epi32(bytes, order));
+    }
+    convertKernelSse41(src + i, dst + i, count - i, edgeValue);
+}
+
+MSDFGEN_C_TARGET("avx512f")
+static void convertKernelAvx512(const float* src, unsigned char* dst, size_t count, unsigned char edgeValue) {
+    const __m512 edge = _mm512_set1_ps(static_cast<float>(edgeValue));
+    const __m512 upper = _mm512_set1_ps(static_cast<float>(255 - edgeValue));
+    const __m512 zero = _mm512_setzero_ps(), half = _mm512_set1_ps(0.5f), one = _mm512_set1_ps(1.0f), two = _mm512_set1_ps(2.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 v = _mm512_max_ps(_mm512_min_ps(_mm512_loadu_ps(src + i), one), zero);
+        __m512 low = _mm512_mul_ps(_mm512_mul_ps(v, two), edge);
+        __m512 high = _mm512_add_ps(edge, _mm512_mul_ps(_mm512_mul_ps(_mm512_sub_ps(v, half), two), upper));
+        __m512 scaled = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(v, half, _CMP_LE_OQ), high, low);
+        __m512i values = _mm512_cvttps_epi32(_mm512_add_ps(scaled, half));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm512_cvtepi32_epi8(values));
+    }
+    convertScalar(src + i, dst + i, count - i, edgeValue);
+}
+
+// Every CPU with AVX2 also implements F16C
+MSDFGEN_C_TARGET("avx2,f16c")
+static void convertHalfKernelF16c(const float* src, unsigned short* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i values = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), values);
+    }
+    convertHalfScalar(src + i, dst + i, count - i);
+}
+
+static const InstructionSet instructionSet = detectInstructionSet();
+
+static ConvertKernel selectKernel() {
+    switch (instructionSet) {
+        case ISA_AVX512: return convertKernelAvx512;
+        case ISA_AVX2: return convertKernelAvx2;
+        case ISA_SSE41: return convertKernelSse41;
+        default: return convertScalar;
+    }
+}
+
+static HalfKernel selectHalfKernel() {
+    return instructionSet >= ISA_AVX2 ? convertHalfKernelF16c : convertHalfScalar;
+}
+
+const char* convertInstructionSet() {
+    switch (instructionSet) {
+        case ISA_AVX512: return "avx512";
+        case ISA_AVX2: return "avx2";
+        case ISA_SSE41: return "sse4.1";
+        default: return "scalar";
+    }
+}
+
+#elif defined(MSDFGEN_C_NEON)
+
+static inline uint32x4_t convertNeon(float32x4_t x, float32x4_t edge, float32x4_t upper) {
+    const float32x4_t zero = vdupq_n_f32(0.0f), half = vdupq_n_f32(0.5f), one = vdupq_n_f32(1.0f), two = vdupq_n_f32(2.0f);
+    // vminnmq returns the number when the other operand is NaN, matching std::min(1.0f, x)
+    float32x4_t v = vmaxq_f32(vminnmq_f32(x, one), zero);
+    float32x4_t low = vmulq_f32(vmulq_f32(v, two), edge);
+    float32x4_t high = vaddq_f32(edge, vmulq_f32(vmulq_f32(vsubq_f32(v, half), two), upper));
+    float32x4_t scaled = vbslq_f32(vcleq_f32(v, half), low, high);
+    return vcvtq_u32_f32(vaddq_f32(scaled, half));
+}
+
+static void convertKernelNeon(const float* src, unsigned char* dst, size_t count, unsigned char edgeValue) {
+    const float32x4_t edge = vdupq_n_f32(static_cast<float>(edgeValue));
+    const float32x4_t upper = vdupq_n_f32(static_cast<float>(255 - edgeValue));
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint16x8_t ab = vcombine_u16(vmovn_u32(convertNeon(vld1q_f32(src + i), edge, upper)), vmovn_u32(convertNeon(vld1q_f32(src + i + 4), edge, upper)));
+        uint16x8_t cd = vcombine_u16(vmovn_u32(convertNeon(vld1q_f32(src + i + 8), edge, upper)), vmovn_u32(convertNeon(vld1q_f32(src + i + 12), edge, upper)));
+        vst1q_u8(dst + i, vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+    }
+    convertScalar(src + i, dst + i, count - i, edgeValue);
+}
+
+static void convertHalfKernelNeon(const float* src, unsigned short* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        float16x8_t values = vcombine_f16(vcvt_f16_f32(vld1q_f32(src + i)), vcvt_f16_f32(vld1q_f32(src + i + 4)));
+        vst1q_u16(dst + i, vreinterpretq_u16_f16(values));
+    }
+    convertHalfScalar(src + i, dst + i, count - i);
+}
+
+static ConvertKernel selectKernel() {
+    return convertKernelNeon;
+}
+
+static HalfKernel selectHalfKernel() {
+    return convertHalfKernelNeon;
+}
+
+const char* convertInstructionSet() {
+    return "neon";
+}
+
+#else
+
+static ConvertKernel selectKernel() {
+    return convertScalar;
+}
+
+static HalfKernel selectHalfKernel() {
+    return convertHalfScalar;
+}
+
+const char* convertInstructionSet() {
+    return "scalar";
+}
+
+#endif
+
+void convertToBytes(const float* src, int srcChannels, unsigned char* dst, int dstChannels, size_t pixelCount, unsigned char edgeValue) {
+    static const ConvertKernel kernel = selectKernel();
+    if (srcChannels == dstChannels) {
+        kernel(src, dst, pixelCount * srcChannels, edgeValue);
+        return;
+    }
+
+    // Convert a chunk with the source layout, then regroup the bytes into the destination layout
+    const size_t chunkValues = 1024;
+    unsigned char converted[chunkValues];
+    int convertedChannels = std::min(srcChannels, dstChannels);
+    // Pixels too wide for the buffer are converted one at a time, only in the channels that are kept
+    bool wide = static_cast<size_t>(srcChannels) > chunkValues;
+    size_t chunkPixels = wide ? 1 : chunkValues / srcChannels;
+    size_t convertedStride = wide ? convertedChannels : srcChannels;
+    for (size_t first = 0; first < pixelCount; first += chunkPixels) {
+        size_t count = std::min(chunkPixels, pixelCount - first);
+        kernel(src + first * srcChannels, converted, count * convertedStride, edgeValue);
+        unsigned char* out = dst + first * dstChannels;
+        for (size_t i = 0; i < count; i++) {
+            int c = 0;
+            for (; c < convertedChannels; c++) {
+                out[c] = converted[i * convertedStride + c];
+            }
+            for (; c < dstChannels; c++) {
+                out[c] = 255;
+            }
+            out += dstChannels;
+        }
+    }
+}
+
+// The unorm loops are simple enough for the compiler to vectorize for the baseline target
+
+void quantizeToUnorm8(const float* src, unsigned char* dst, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float val = std::max(0.0f, std::min(1.0f, src[i]));
+        dst[i] = static_cast<unsigned char>(val * 255.0f + 0.5f);
+    }
+}
+
+void quantizeToUnorm16(const float* src, unsigned short* dst, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float val = std::max(0.0f, std::min(1.0f, src[i]));
+        dst[i] = static_cast<unsigned short>(val * 65535.0f + 0.5f);
+    }
+}
+
+void convertToHalf(const float* src, unsigned short* dst, size_t count) {
+    static const HalfKernel kernel = selectHalfKernel();
+    kernel(src, dst, count);
+}
+
+}
@@ -0,0 +1,33 @@
+/*
+ * Internal float pixel conversion to bytes and quantized formats with runtime CPU dispatch
+ */
+
+#ifndef MSDFGEN_C_CONVERT_H
+#define MSDFGEN_C_CONVERT_H
+
+#include <cstddef>
+
+namespace msdfgen_c {
+
+/*
+ * Converts pixelCount tightly packed pixels to bytes, mapping 0.5 to edgeValue.
+ * The first min(srcChannels, dstChannels) channels are converted and any
+ * destination channels beyond srcChannels are set to 255.
+ */
+void convertToBytes(const float* src, int srcChannels, unsigned char* dst, int dstChannels, size_t pixelCount, unsigned char edgeValue);
+
+/* Stores count values clamped to [0, 1] as round(value * 255) */
+void quantizeToUnorm8(const float* src, unsigned char* dst, size_t count);
+
+/* Stores count values clamped to [0, 1] as round(value * 65535) */
+void quantizeToUnorm16(const float* src, unsigned short* dst, size_t count);
+
+/* Stores count values as IEEE 754 half floats, rounded to nearest even */
+void convertToHalf(const float* src, unsigned short* dst, size_t count);
+
+/* Name of the instruction set selected for this CPU, e.g. "avx2" */
+const char* convertInstructionSet();
+
+}
+
+#endif /* MSDFGEN_C_CONVERT_H */
@@ -0,0 +1,50 @@
+/*
+ * Internal instruction set detection shared by the SIMD kernels
+ */
+
+#include "msdfgen_c_cpu.h"
+
+namespace msdfgen_c {
+
+#ifdef MSDFGEN_C_X86
+
+static InstructionSet queryInstructionSet() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    if (maxLeaf < 1) return ISA_SCALAR;
+    __cpuid(info, 1);
+    bool sse41 = (info[2] & (1 << 19)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    bool avxState = (xcr0 & 0x6) == 0x6;
+    bool avx512State = (xcr0 & 0xe6) == 0xe6;
+    bool avx2 = false, avx512f = false;
+    if (maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+        avx512f = (info[1] & (1 << 16)) != 0;
+    }
+    if (avx512f && avx512State) return ISA_AVX512;
+    if (avx2 && avx && avxState) return ISA_AVX2;
+    if (sse41) return ISA_SSE41;
+    return ISA_SCALAR;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return ISA_AVX512;
+    if (__builtin_cpu_supports("avx2")) return ISA_AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return ISA_SSE41;
+    return ISA_SCALAR;
+#endif
+}
+
+InstructionSet detectInstructionSet() {
+    static const InstructionSet instructionSet = queryInstructionSet();
+    return instructionSet;
+}
+
+#endif
+
+}
@@ -0,0 +1,47 @@
+/*
+ * Internal instruction set detection shared by the SIMD kernels
+ */
+
+#ifndef MSDFGEN_C_CPU_H
+#define MSDFGEN_C_CPU_H
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define MSDFGEN_C_X86
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define MSDFGEN_C_TARGET(isa)
+    #else
+        #define MSDFGEN_C_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define MSDFGEN_C_NEON
+    #include <arm_neon.h>
+#endif
+
+/* Inlines every call of a kernel entry point, so that generic helpers are compiled for its instruction set */
+#ifdef _MSC_VER
+    #define MSDFGEN_C_FLATTEN
+#else
+    #define MSDFGEN_C_FLATTEN __attribute__((flatten))
+#endif
+
+namespace msdfgen_c {
+
+#ifdef MSDFGEN_C_X86
+
+enum InstructionSet {
+    ISA_SCALAR,
+    ISA_SSE41,
+    ISA_AVX2,
+    ISA_AVX512
+};
+
+/* Widest instruction set supported by both the CPU and the OS, detected on the first call */
+InstructionSet detectInstructionSet();
+
+#endif
+
+}
+
+#endif /* MSDFGEN_C_CPU_H */
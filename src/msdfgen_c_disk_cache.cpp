@@ -0,0 +1,254 @@
+/*
+ * Internal persistent cache implementation
+ */
+
+#include "msdfgen_c_disk_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+namespace msdfgen_c {
+
+#define MSDFGEN_C_DISK_CACHE_FORMAT 1
+#define MSDFGEN_C_DISK_CACHE_ALIGNMENT 16
+
+static const char cacheMagic[8] = {'M', 'S', 'D', 'F', 'G', 'D', 'C', '\0'};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t format;
+    uint32_t headerSize;
+    char libraryVersion[32];
+    uint64_t reserved[2];
+};
+
+struct EntryHeader {
+    uint64_t keyLow;
+    uint64_t keyHigh;
+    uint64_t payloadSize;
+    uint64_t reserved;
+};
+
+static uint64_t alignedSize(uint64_t size) {
+    return (size + MSDFGEN_C_DISK_CACHE_ALIGNMENT - 1) & ~static_cast<uint64_t>(MSDFGEN_C_DISK_CACHE_ALIGNMENT - 1);
+}
+
+static uint64_t entryFootprint(uint64_t payloadSize) {
+    return sizeof(EntryHeader) + alignedSize(payloadSize);
+}
+
+static FILE* openFile(const std::string& path, const char* mode) {
+#ifdef _WIN32
+    std::filesystem::path filePath = std::filesystem::u8path(path);
+    std::wstring wideMode(mode, mode + strlen(mode));
+    return _wfopen(filePath.c_str(), wideMode.c_str());
+#else
+    return fopen(path.c_str(), mode);
+#endif
+}
+
+static bool writeEntry(FILE* file, const CacheKey& key, const void* data, uint64_t payloadSize) {
+    static const unsigned char padding[MSDFGEN_C_DISK_CACHE_ALIGNMENT] = { };
+    EntryHeader header = {key.low, key.high, payloadSize, 0};
+    size_t paddingSize = static_cast<size_t>(alignedSize(payloadSize) - payloadSize);
+    return fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(data, 1, static_cast<size_t>(payloadSize), file) == payloadSize &&
+        fwrite(padding, 1, paddingSize, file) == paddingSize;
+}
+
+static void fillHeader(FileHeader& header, const std::string& libraryVersion) {
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.format = MSDFGEN_C_DISK_CACHE_FORMAT;
+    header.headerSize = sizeof(FileHeader);
+    strncpy(header.libraryVersion, libraryVersion.c_str(), sizeof(header.libraryVersion) - 1);
+}
+
+DiskCache::DiskCache() : maxBytes(0), fileSize(0), useCounter(0), appendFile(nullptr) { }
+
+DiskCache::~DiskCache() {
+    if (appendFile) fclose(appendFile);
+}
+
+std::shared_ptr<DiskCache> DiskCache::open(const char* path, uint64_t maxBytes, const char* libraryVersion) {
+    std::shared_ptr<DiskCache> cache(new DiskCache());
+    cache->path = path;
+    cache->libraryVersion = libraryVersion;
+    cache->maxBytes = maxBytes;
+    // Only files that carry the cache magic are ever truncated, so a mistyped path cannot destroy a file
+    ScanResult scanned = cache->scan();
+    if (scanned == SCAN_FOREIGN || (scanned == SCAN_STALE && !cache->reset())) {
+        return nullptr;
+    }
+    if (!cache->reopenAppend()) {
+        return nullptr;
+    }
+    return cache;
+}
+
+/* Truncates the file to an empty cache of the current version */
+bool DiskCache::reset() {
+    mapping.close();
+    entries.clear();
+    if (appendFile) {
+        fclose(appendFile);
+        appendFile = nullptr;
+    }
+    FILE* file = openFile(path, "wb");
+    if (!file) return false;
+    FileHeader header;
+    fillHeader(header, libraryVersion);
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+    written = fclose(file) == 0 && written;
+    fileSize = sizeof(FileHeader);
+    return written;
+}
+
+/* Maps the existing file and indexes its entries if it is a cache of the current format and version */
+DiskCache::ScanResult DiskCache::scan() {
+    entries.clear();
+    if (!mapping.open(path.c_str())) {
+        std::error_code error;
+        bool exists = std::filesystem::exists(std::filesystem::u8path(path), error);
+        return exists || error ? SCAN_FOREIGN : SCAN_STALE;
+    }
+    if (mapping.size() == 0) return SCAN_STALE;
+
+    // A file shorter than the magic counts as a cache if it begins like one, as a header write may have been cut short
+    size_t magicSize = static_cast<size_t>(std::min<uint64_t>(mapping.size(), sizeof(cacheMagic)));
+    if (memcmp(mapping.data(), cacheMagic, magicSize)) {
+        mapping.close();
+        return SCAN_FOREIGN;
+    }
+    if (mapping.size() < sizeof(FileHeader)) return SCAN_STALE;
+    FileHeader expected, header;
+    fillHeader(expected, libraryVersion);
+    memcpy(&header, mapping.data(), sizeof(header));
+    if (header.format != expected.format || header.headerSize != expected.headerSize ||
+        memcmp(header.libraryVersion, expected.libraryVersion, sizeof(header.libraryVersion))) {
+        return SCAN_STALE;
+    }
+
+    // Older entries get lower use counts so they are evicted first; a torn entry at the end is dropped
+    uint64_t offset = sizeof(FileHeader);
+    while (offset + sizeof(EntryHeader) <= mapping.size()) {
+        EntryHeader entryHeader;
+        memcpy(&entryHeader, mapping.data() + offset, sizeof(entryHeader));
+        uint64_t footprint = entryFootprint(entryHeader.payloadSize);
+        if (entryHeader.payloadSize > mapping.size() || offset + footprint > mapping.size()) break;
+        CacheKey key = {entryHeader.keyLow, entryHeader.keyHigh};
+        Entry entry = {offset + sizeof(EntryHeader), entryHeader.payloadSize, ++useCounter};
+        entries[key] = entry;
+        offset += footprint;
+    }
+    fileSize = offset;
+    if (offset < mapping.size()) {
+        mapping.close();
+        std::error_code error;
+        std::filesystem::resize_file(std::filesystem::u8path(path), offset, error);
+        if (error || !mapping.open(path.c_str())) return SCAN_STALE;
+    }
+    return SCAN_LOADED;
+}
+
+bool DiskCache::reopenAppend() {
+    if (appendFile) fclose(appendFile);
+    appendFile = openFile(path, "ab");
+    return appendFile != nullptr;
+}
+
+bool DiskCache::load(const CacheKey& key, size_t byteSize, const std::function<void(const unsigned char*)>& consume) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<CacheKey, Entry, CacheKeyHash>::iterator it = entries.find(key);
+    if (it == entries.end() || it->second.size != byteSize) return false;
+    if (it->second.offset + it->second.size > mapping.size()) {
+        // Written after the file was last mapped
+        if (!mapping.open(path.c_str()) || it->second.offset + it->second.size > mapping.size()) return false;
+    }
+    it->second.lastUse = ++useCounter;
+    consume(mapping.data() + it->second.offset);
+    return true;
+}
+
+void DiskCache::store(const CacheKey& key, const void* data, size_t byteSize) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!appendFile || entries.count(key) || entryFootprint(byteSize) + sizeof(FileHeader) > maxBytes) return;
+    if (!writeEntry(appendFile, key, data, byteSize) || fflush(appendFile) != 0) {
+        // A failed write may leave a torn entry behind, so start over with an empty file
+        reset();
+        reopenAppend();
+        return;
+    }
+    Entry entry = {fileSize + sizeof(EntryHeader), byteSize, ++useCounter};
+    entries[key] = entry;
+    fileSize += entryFootprint(byteSize);
+    if (fileSize > maxBytes && !compact()) {
+        reset();
+        reopenAppend();
+    }
+}
+
+void DiskCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    reset();
+    reopenAppend();
+}
+
+/* Rewrites the file with the most recently used entries filling three quarters of the size cap */
+bool DiskCache::compact() {
+    if (!mapping.open(path.c_str())) return false;
+
+    std::vector<std::pair<CacheKey, Entry> > kept(entries.begin(), entries.end());
+    std::sort(kept.begin(), kept.end(), [](const std::pair<CacheKey, Entry>& a, const std::pair<CacheKey, Entry>& b) {
+        return a.second.lastUse > b.second.lastUse;
+    });
+    uint64_t budget = maxBytes / 4 * 3;
+    uint64_t newSize = sizeof(FileHeader);
+    size_t keptCount = 0;
+    while (keptCount < kept.size() && newSize + entryFootprint(kept[keptCount].second.size) <= budget) {
+        newSize += entryFootprint(kept[keptCount].second.size);
+        keptCount++;
+    }
+    kept.resize(keptCount);
+    // Least recently used first, so that file order reflects recency on the next open
+    std::reverse(kept.begin(), kept.end());
+
+    std::string tempPath = path + ".tmp";
+    FILE* file = openFile(tempPath, "wb");
+    if (!file) return false;
+    FileHeader header;
+    fillHeader(header, libraryVersion);
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+    uint64_t offset = sizeof(FileHeader);
+    entries.clear();
+    for (size_t i = 0; written && i < kept.size(); i++) {
+        const Entry& old = kept[i].second;
+        written = writeEntry(file, kept[i].first, mapping.data() + old.offset, old.size);
+        Entry entry = {offset + sizeof(EntryHeader), old.size, old.lastUse};
+        entries[kept[i].first] = entry;
+        offset += entryFootprint(old.size);
+    }
+    written = fclose(file) == 0 && written;
+
+    mapping.close();
+    if (appendFile) {
+        fclose(appendFile);
+        appendFile = nullptr;
+    }
+    std::error_code error;
+    if (written) {
+        std::filesystem::rename(std::filesystem::u8path(tempPath), std::filesystem::u8path(path), error);
+    }
+    if (!written || error) {
+        std::filesystem::remove(std::filesystem::u8path(tempPath), error);
+        entries.clear();
+        return false;
+    }
+    fileSize = offset;
+    return mapping.open(path.c_str()) && reopenAppend();
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Internal persistent cache of generated distance fields
+ */
+
+#ifndef MSDFGEN_C_DISK_CACHE_H
+#define MSDFGEN_C_DISK_CACHE_H
+
+#include "msdfgen_c_hash.h"
+#include "msdfgen_c_mapped_file.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace msdfgen_c {
+
+/*
+ * Append-only cache file: a header carrying the format and build version,
+ * followed by entries of key, payload size and payload. The file is memory
+ * mapped for reads and remapped when it has grown. When it exceeds its size cap,
+ * it is rewritten keeping the most recently used entries.
+ * Intended for use by a single process at a time.
+ */
+class DiskCache {
+
+public:
+    /* Opens or creates the cache file; a cache written by a different build version is discarded, any other file is left alone and fails */
+    static std::shared_ptr<DiskCache> open(const char* path, uint64_t maxBytes, const char* libraryVersion);
+
+    ~DiskCache();
+
+    /* Calls consume with the cached payload if present with exactly byteSize bytes */
+    bool load(const CacheKey& key, size_t byteSize, const std::function<void(const unsigned char*)>& consume);
+    void store(const CacheKey& key, const void* data, size_t byteSize);
+    void clear();
+
+private:
+    struct Entry {
+        uint64_t offset;
+        uint64_t size;
+        uint64_t lastUse;
+    };
+
+    enum ScanResult {
+        SCAN_LOADED,    /* A cache of the current format and version, now indexed */
+        SCAN_STALE,     /* No file, an empty one, or a cache of another format or version */
+        SCAN_FOREIGN    /* A file that is not a cache, or cannot be read */
+    };
+
+    std::mutex mutex;
+    std::string path;
+    std::string libraryVersion;
+    uint64_t maxBytes;
+    uint64_t fileSize;
+    uint64_t useCounter;
+    FILE* appendFile;
+    MappedFile mapping;
+    std::unordered_map<CacheKey, Entry, CacheKeyHash> entries;
+
+    DiskCache();
+    bool reset();
+    ScanResult scan();
+    bool compact();
+    bool reopenAppend();
+
+};
+
+}
+
+#endif /* MSDFGEN_C_DISK_CACHE_H */
@@ -0,0 +1,93 @@
+/*
+ * Internal pieces of msdfgen's ShapeDistanceFinder shared by the generators that reproduce it
+ */
+
+#ifndef MSDFGEN_C_DISTANCE_FINDER_H
+#define MSDFGEN_C_DISTANCE_FINDER_H
+
+#include "msdfgen.h"
+
+#include <cmath>
+#include <cstddef>
+
+namespace msdfgen_c {
+
+/* Factor by which msdfgen's edge cache overestimates how far a sample has moved */
+#define MSDFGEN_C_DISTANCE_DELTA_FACTOR 1.001
+
+/*
+ * The i-th edge of the contour in the order ShapeDistanceFinder visits them, which
+ * starts from the contour's last edge. Ties between equally near edges go to the
+ * first one visited, so every generator that numbers edges this way resolves them alike.
+ */
+inline const msdfgen::EdgeSegment* visitedEdge(const msdfgen::Contour& contour, size_t i) {
+    size_t count = contour.edges.size();
+    return contour.edges[(i + count - 1) % count];
+}
+
+/*
+ * msdfgen's OverlappingContourCombiner at one point: the distance of the contours
+ * that bound the filled area around it. A Selector is empty when default constructed
+ * and provides merge(), distance(context...) and a static resolve() of a distance to
+ * a scalar. contourDistances receives the distance of each contour's selector.
+ */
+template <class Selector, class... Context>
+typename Selector::Distance combineOverlapping(const Selector* contours, const int* windings, int contourCount, typename Selector::Distance* contourDistances, const Context&... context) {
+    typedef typename Selector::Distance Distance;
+    Selector shapeSelector, innerSelector, outerSelector;
+    for (int i = 0; i < contourCount; i++) {
+        contourDistances[i] = contours[i].distance(context...);
+        auto contourDistance = Selector::resolve(contourDistances[i]);
+        shapeSelector.merge(contours[i]);
+        if (windings[i] > 0 && contourDistance >= 0) {
+            innerSelector.merge(contours[i]);
+        }
+        if (windings[i] < 0 && contourDistance <= 0) {
+            outerSelector.merge(contours[i]);
+        }
+    }
+
+    Distance shapeDistance = shapeSelector.distance(context...);
+    Distance innerDistance = innerSelector.distance(context...);
+    Distance outerDistance = outerSelector.distance(context...);
+    auto inner = Selector::resolve(innerDistance), outer = Selector::resolve(outerDistance);
+    Distance distance;
+    int winding;
+    if (inner >= 0 && std::fabs(inner) <= std::fabs(outer)) {
+        distance = innerDistance;
+        winding = 1;
+        for (int i = 0; i < contourCount; i++) {
+            auto contourDistance = Selector::resolve(contourDistances[i]);
+            if (windings[i] > 0 && std::fabs(contourDistance) < std::fabs(outer) && contourDistance > Selector::resolve(distance)) {
+                distance = contourDistances[i];
+            }
+        }
+    } else if (outer <= 0 && std::fabs(outer) < std::fabs(inner)) {
+        distance = outerDistance;
+        winding = -1;
+        for (int i = 0; i < contourCount; i++) {
+            auto contourDistance = Selector::resolve(contourDistances[i]);
+            if (windings[i] < 0 && std::fabs(contourDistance) < std::fabs(inner) && contourDistance < Selector::resolve(distance)) {
+                distance = contourDistances[i];
+            }
+        }
+    } else {
+        return shapeDistance;
+    }
+
+    for (int i = 0; i < contourCount; i++) {
+        auto contourDistance = Selector::resolve(contourDistances[i]);
+        auto resolved = Selector::resolve(distance);
+        if (windings[i] != winding && contourDistance * resolved >= 0 && std::fabs(contourDistance) < std::fabs(resolved)) {
+            distance = contourDistances[i];
+        }
+    }
+    if (Selector::resolve(distance) == Selector::resolve(shapeDistance)) {
+        distance = shapeDistance;
+    }
+    return distance;
+}
+
+}
+
+#endif /* MSDFGEN_C_DISTANCE_FINDER_H */
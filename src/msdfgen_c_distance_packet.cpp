@@ -0,0 +1,1112 @@
+/*
+ * Internal SIMD evaluation of edge distances over packets of neighboring pixels
+ *
+ * The packet kernels are written once against a small vector interface and are
+ * compiled for each instruction set by flattening them into a kernel entry point
+ * with that target. Linear segments repeat the operations of the scalar kernel in
+ * msdfgen_c_flat_shape.cpp lane by lane. Quadratic segments do the same except for
+ * the cubic equation, whose acos, sin, cos and cube root are replaced by
+ * polynomial approximations accurate to single precision. Cubic segments have no
+ * closed form and go through the scalar kernel one lane at a time. This file is
+ * built without floating-point contraction, like the scalar kernels, so that the
+ * shared operations round alike.
+ *
+ * The SDF kernel without overlap support keeps only the nearest distance of each
+ * lane. The selector kernels keep the state of msdfgen's edge selectors per lane
+ * instead, one set per contour with overlap support, and finish every pixel with
+ * the scalar code of its contour combiners.
+ */
+
+#include "msdfgen_c_distance_packet.h"
+#include "msdfgen_c_cpu.h"
+#include "msdfgen_c_distance_finder.h"
+#include "msdfgen_c_flat_shape.h"
+#include "msdfgen_c_pooled_shape.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace msdfgen;
+
+namespace msdfgen_c {
+
+/* Widest packet of any kernel; column buffers are padded to a multiple of it */
+#define MSDFGEN_C_MAX_PACKET_WIDTH 16
+
+/* Relative slack on the edge bounds test, far above the rounding error of a distance */
+#define MSDFGEN_C_PACKET_CULL_SLACK 1e-5f
+
+/* ============================================================================
+ * Vector types
+ * ============================================================================ */
+
+/*
+ * Each vector type has a width, a Mask type, set() and load() constructors, store(),
+ * the arithmetic operators, comparisons that yield masks and the functions below.
+ */
+
+#ifdef MSDFGEN_C_X86
+
+struct Avx2Mask {
+    __m256 m;
+};
+
+struct Avx2Float {
+    typedef Avx2Mask Mask;
+    static constexpr int width = 8;
+    __m256 v;
+
+    MSDFGEN_C_TARGET("avx2") static inline Avx2Float set(float x) { return {_mm256_set1_ps(x)}; }
+    MSDFGEN_C_TARGET("avx2") static inline Avx2Float load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    MSDFGEN_C_TARGET("avx2") inline void store(float* p) const { _mm256_storeu_ps(p, v); }
+};
+
+MSDFGEN_C_TARGET("avx2") static inline Avx2Float operator+(Avx2Float a, Avx2Float b) { return {_mm256_add_ps(a.v, b.v)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Float operator-(Avx2Float a, Avx2Float b) { return {_mm256_sub_ps(a.v, b.v)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Float operator*(Avx2Float a, Avx2Float b) { return {_mm256_mul_ps(a.v, b.v)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Float operator/(Avx2Float a, Avx2Float b) { return {_mm256_div_ps(a.v, b.v)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Float operator-(Avx2Float a) { return {_mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f))}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Mask operator<(Avx2Float a, Avx2Float b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Mask operator<=(Avx2Float a, Avx2Float b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Mask operator>(Avx2Float a, Avx2Float b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Mask operator>=(Avx2Float a, Avx2Float b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Mask operator==(Avx2Float a, Avx2Float b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Mask operator!=(Avx2Float a, Avx2Float b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_NEQ_UQ)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Mask operator&(Avx2Mask a, Avx2Mask b) { return {_mm256_and_ps(a.m, b.m)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Mask operator|(Avx2Mask a, Avx2Mask b) { return {_mm256_or_ps(a.m, b.m)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Mask operator~(Avx2Mask a) { return {_mm256_xor_ps(a.m, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Float select(Avx2Mask m, Avx2Float a, Avx2Float b) { return {_mm256_blendv_ps(b.v, a.v, m.m)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Float vsqrt(Avx2Float a) { return {_mm256_sqrt_ps(a.v)}; }
+MSDFGEN_C_TARGET("avx2") static inline Avx2Float vabs(Avx2Float a) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+
+MSDFGEN_C_TARGET("avx2") static inline float hmax(Avx2Float a) {
+    __m128 m = _mm_max_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+    m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_max_ss(m, _mm_movehdup_ps(m));
+    return _mm_cvtss_f32(m);
+}
+
+/* Bit pattern estimate of the cube root of a nonnegative number, within a few percent */
+MSDFGEN_C_TARGET("avx2") static inline Avx2Float cbrtEstimate(Avx2Float a) {
+    __m256 bits = _mm256_cvtepi32_ps(_mm256_castps_si256(a.v));
+    __m256i estimate = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(bits, _mm256_set1_ps(float(1 / 3.))), _mm256_set1_ps(709921077.0f)));
+    return {_mm256_castsi256_ps(estimate)};
+}
+
+struct Avx512Float {
+    typedef __mmask16 Mask;
+    static constexpr int width = 16;
+    __m512 v;
+
+    MSDFGEN_C_TARGET("avx512f") static inline Avx512Float set(float x) { return {_mm512_set1_ps(x)}; }
+    MSDFGEN_C_TARGET("avx512f") static inline Avx512Float load(const float* p) { return {_mm512_loadu_ps(p)}; }
+    MSDFGEN_C_TARGET("avx512f") inline void store(float* p) const { _mm512_storeu_ps(p, v); }
+};
+
+MSDFGEN_C_TARGET("avx512f") static inline Avx512Float operator+(Avx512Float a, Avx512Float b) { return {_mm512_add_ps(a.v, b.v)}; }
+MSDFGEN_C_TARGET("avx512f") static inline Avx512Float operator-(Avx512Float a, Avx512Float b) { return {_mm512_sub_ps(a.v, b.v)}; }
+MSDFGEN_C_TARGET("avx512f") static inline Avx512Float operator*(Avx512Float a, Avx512Float b) { return {_mm512_mul_ps(a.v, b.v)}; }
+MSDFGEN_C_TARGET("avx512f") static inline Avx512Float operator/(Avx512Float a, Avx512Float b) { return {_mm512_div_ps(a.v, b.v)}; }
+MSDFGEN_C_TARGET("avx512f") static inline Avx512Float operator-(Avx512Float a) { return {_mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(INT32_MIN)))}; }
+MSDFGEN_C_TARGET("avx512f") static inline __mmask16 operator<(Avx512Float a, Avx512Float b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ); }
+MSDFGEN_C_TARGET("avx512f") static inline __mmask16 operator<=(Avx512Float a, Avx512Float b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ); }
+MSDFGEN_C_TARGET("avx512f") static inline __mmask16 operator>(Avx512Float a, Avx512Float b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ); }
+MSDFGEN_C_TARGET("avx512f") static inline __mmask16 operator>=(Avx512Float a, Avx512Float b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ); }
+MSDFGEN_C_TARGET("avx512f") static inline __mmask16 operator==(Avx512Float a, Avx512Float b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ); }
+MSDFGEN_C_TARGET("avx512f") static inline __mmask16 operator!=(Avx512Float a, Avx512Float b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_NEQ_UQ); }
+MSDFGEN_C_TARGET("avx512f") static inline Avx512Float select(__mmask16 m, Avx512Float a, Avx512Float b) { return {_mm512_mask_blend_ps(m, b.v, a.v)}; }
+MSDFGEN_C_TARGET("avx512f") static inline Avx512Float vsqrt(Avx512Float a) { return {_mm512_sqrt_ps(a.v)}; }
+MSDFGEN_C_TARGET("avx512f") static inline Avx512Float vabs(Avx512Float a) { return {_mm512_abs_ps(a.v)}; }
+MSDFGEN_C_TARGET("avx512f") static inline float hmax(Avx512Float a) { return _mm512_reduce_max_ps(a.v); }
+
+MSDFGEN_C_TARGET("avx512f") static inline Avx512Float cbrtEstimate(Avx512Float a) {
+    __m512 bits = _mm512_cvtepi32_ps(_mm512_castps_si512(a.v));
+    __m512i estimate = _mm512_cvttps_epi32(_mm512_add_ps(_mm512_mul_ps(bits, _mm512_set1_ps(float(1 / 3.))), _mm512_set1_ps(709921077.0f)));
+    return {_mm512_castsi512_ps(estimate)};
+}
+
+#elif defined(MSDFGEN_C_NEON)
+
+struct NeonMask {
+    uint32x4_t m;
+};
+
+struct NeonFloat {
+    typedef NeonMask Mask;
+    static constexpr int width = 4;
+    float32x4_t v;
+
+    static inline NeonFloat set(float x) { return {vdupq_n_f32(x)}; }
+    static inline NeonFloat load(const float* p) { return {vld1q_f32(p)}; }
+    inline void store(float* p) const { vst1q_f32(p, v); }
+};
+
+static inline NeonFloat operator+(NeonFloat a, NeonFloat b) { return {vaddq_f32(a.v, b.v)}; }
+static inline NeonFloat operator-(NeonFloat a, NeonFloat b) { return {vsubq_f32(a.v, b.v)}; }
+static inline NeonFloat operator*(NeonFloat a, NeonFloat b) { return {vmulq_f32(a.v, b.v)}; }
+static inline NeonFloat operator/(NeonFloat a, NeonFloat b) { return {vdivq_f32(a.v, b.v)}; }
+static inline NeonFloat operator-(NeonFloat a) { return {vnegq_f32(a.v)}; }
+static inline NeonMask operator<(NeonFloat a, NeonFloat b) { return {vcltq_f32(a.v, b.v)}; }
+static inline NeonMask operator<=(NeonFloat a, NeonFloat b) { return {vcleq_f32(a.v, b.v)}; }
+static inline NeonMask operator>(NeonFloat a, NeonFloat b) { return {vcgtq_f32(a.v, b.v)}; }
+static inline NeonMask operator>=(NeonFloat a, NeonFloat b) { return {vcgeq_f32(a.v, b.v)}; }
+static inline NeonMask operator==(NeonFloat a, NeonFloat b) { return {vceqq_f32(a.v, b.v)}; }
+static inline NeonMask operator!=(NeonFloat a, NeonFloat b) { return {vmvnq_u32(vceqq_f32(a.v, b.v))}; }
+static inline NeonMask operator&(NeonMask a, NeonMask b) { return {vandq_u32(a.m, b.m)}; }
+static inline NeonMask operator|(NeonMask a, NeonMask b) { return {vorrq_u32(a.m, b.m)}; }
+static inline NeonMask operator~(NeonMask a) { return {vmvnq_u32(a.m)}; }
+static inline NeonFloat select(NeonMask m, NeonFloat a, NeonFloat b) { return {vbslq_f32(m.m, a.v, b.v)}; }
+static inline NeonFloat vsqrt(NeonFloat a) { return {vsqrtq_f32(a.v)}; }
+static inline NeonFloat vabs(NeonFloat a) { return {vabsq_f32(a.v)}; }
+static inline float hmax(NeonFloat a) { return vmaxvq_f32(a.v); }
+
+static inline NeonFloat cbrtEstimate(NeonFloat a) {
+    float32x4_t bits = vcvtq_f32_s32(vreinterpretq_s32_f32(a.v));
+    int32x4_t estimate = vcvtq_s32_f32(vaddq_f32(vmulq_f32(bits, vdupq_n_f32(float(1 / 3.))), vdupq_n_f32(709921077.0f)));
+    return {vreinterpretq_f32_s32(estimate)};
+}
+
+#endif
+
+/* Single lanes, for the selector kernels on CPUs without one of the instruction sets above */
+
+struct ScalarMask {
+    bool m;
+};
+
+struct ScalarFloat {
+    typedef ScalarMask Mask;
+    static constexpr int width = 1;
+    float v;
+
+    static inline ScalarFloat set(float x) { return {x}; }
+    static inline ScalarFloat load(const float* p) { return {*p}; }
+    inline void store(float* p) const { *p = v; }
+};
+
+static inline ScalarFloat operator+(ScalarFloat a, ScalarFloat b) { return {a.v + b.v}; }
+static inline ScalarFloat operator-(ScalarFloat a, ScalarFloat b) { return {a.v - b.v}; }
+static inline ScalarFloat operator*(ScalarFloat a, ScalarFloat b) { return {a.v * b.v}; }
+static inline ScalarFloat operator/(ScalarFloat a, ScalarFloat b) { return {a.v / b.v}; }
+static inline ScalarFloat operator-(ScalarFloat a) { return {-a.v}; }
+static inline ScalarMask operator<(ScalarFloat a, ScalarFloat b) { return {a.v < b.v}; }
+static inline ScalarMask operator<=(ScalarFloat a, ScalarFloat b) { return {a.v <= b.v}; }
+static inline ScalarMask operator>(ScalarFloat a, ScalarFloat b) { return {a.v > b.v}; }
+static inline ScalarMask operator>=(ScalarFloat a, ScalarFloat b) { return {a.v >= b.v}; }
+static inline ScalarMask operator==(ScalarFloat a, ScalarFloat b) { return {a.v == b.v}; }
+static inline ScalarMask operator!=(ScalarFloat a, ScalarFloat b) { return {a.v != b.v}; }
+static inline ScalarMask operator&(ScalarMask a, ScalarMask b) { return {a.m && b.m}; }
+static inline ScalarMask operator|(ScalarMask a, ScalarMask b) { return {a.m || b.m}; }
+static inline ScalarMask operator~(ScalarMask a) { return {!a.m}; }
+static inline ScalarFloat select(ScalarMask m, ScalarFloat a, ScalarFloat b) { return m.m ? a : b; }
+static inline ScalarFloat vsqrt(ScalarFloat a) { return {std::sqrt(a.v)}; }
+static inline ScalarFloat vabs(ScalarFloat a) { return {std::fabs(a.v)}; }
+static inline float hmax(ScalarFloat a) { return a.v; }
+
+static inline ScalarFloat cbrtEstimate(ScalarFloat a) {
+    int32_t bits;
+    std::memcpy(&bits, &a.v, sizeof(bits));
+    int32_t estimate = static_cast<int32_t>(float(bits) * float(1 / 3.) + 709921077.0f);
+    ScalarFloat result;
+    std::memcpy(&result.v, &estimate, sizeof(estimate));
+    return result;
+}
+
+/* ============================================================================
+ * Packet kernels
+ * ============================================================================ */
+
+/* Signed distances of the lanes and the segment parameters of their nearest points */
+template <class V>
+struct PacketDistance {
+    V distance;
+    V dot;
+    V param;
+};
+
+/* nonZeroSign(n) * value of the scalar kernels */
+template <class V>
+static inline V signedBy(V n, V value) {
+    return select(n > V::set(0), value, -value);
+}
+
+/* Vector2::normalize(), which maps the zero vector to (0, 1) */
+static inline void normalize(float& x, float& y) {
+    float len = std::sqrt(x * x + y * y);
+    if (len == 0) {
+        x = 0, y = 1;
+    } else {
+        x /= len, y /= len;
+    }
+}
+
+/* normalize() of each lane */
+template <class V>
+static inline void normalizeLanes(V& x, V& y) {
+    V len = vsqrt(x * x + y * y);
+    typename V::Mask zero = len == V::set(0);
+    x = select(zero, V::set(0), x / len);
+    y = select(zero, V::set(1), y / len);
+}
+
+/* acos on [-1, 1] through the asin polynomial of the Cephes library */
+template <class V>
+static inline V acosLanes(V x) {
+    V ax = vabs(x);
+    typename V::Mask outer = ax > V::set(.5f);
+    V z = select(outer, V::set(.5f) * (V::set(1) - ax), x * x);
+    V s = select(outer, vsqrt(z), ax);
+    V p = (((V::set(4.2163199048e-2f) * z + V::set(2.4181311049e-2f)) * z + V::set(4.5470025998e-2f)) * z + V::set(7.4953002686e-2f)) * z + V::set(1.6666752422e-1f);
+    p = s + s * z * p;
+    typename V::Mask negative = x < V::set(0);
+    V outerAngle = select(negative, V::set(3.14159265358979f) - V::set(2) * p, V::set(2) * p);
+    V innerAngle = V::set(1.57079632679490f) - select(negative, -p, p);
+    return select(outer, outerAngle, innerAngle);
+}
+
+/* sin and cos on [0, pi/3] by their Taylor series up to the 13th degree */
+template <class V>
+static inline void sinCosLanes(V x, V& sinX, V& cosX) {
+    V z = x * x;
+    V c = ((((((V::set(float(1 / 479001600.)) * z - V::set(float(1 / 3628800.))) * z + V::set(float(1 / 40320.))) * z - V::set(float(1 / 720.))) * z + V::set(float(1 / 24.))) * z - V::set(.5f)) * z) + V::set(1);
+    V s = ((((((V::set(float(1 / 6227020800.)) * z - V::set(float(1 / 39916800.))) * z + V::set(float(1 / 362880.))) * z - V::set(float(1 / 5040.))) * z + V::set(float(1 / 120.))) * z - V::set(float(1 / 6.))) * z) + V::set(1);
+    sinX = x * s;
+    cosX = c;
+}
+
+/* Cube root of nonnegative lanes by Newton's method from the bit pattern estimate */
+template <class V>
+static inline V cbrtLanes(V x) {
+    V y = cbrtEstimate(x);
+    for (int i = 0; i < 4; i++) {
+        y = y - (y * y * y - x) / (V::set(3) * y * y);
+    }
+    return select(x == V::set(0), V::set(0), y);
+}
+
+/* solveQuadratic of the scalar kernels for a uniform a; missing roots are NaN */
+template <class V>
+static inline void solveQuadraticLanes(V x[3], float a, V b, V c) {
+    const V nan = V::set(std::numeric_limits<float>::quiet_NaN());
+    V linearRoot = select(b != V::set(0), -c / b, nan);
+    x[2] = nan;
+    if (a == 0) {
+        x[0] = linearRoot;
+        x[1] = nan;
+        return;
+    }
+    typename V::Mask linear = vabs(b) > V::set(SolverLimits<float>::linearRatio * std::fabs(a));
+    V dscr = b * b - V::set(4 * a) * c;
+    V root = vsqrt(dscr);
+    V twoA = V::set(2 * a);
+    typename V::Mask two = dscr > V::set(0);
+    V single = select(dscr == V::set(0), -b / twoA, nan);
+    x[0] = select(linear, linearRoot, select(two, (-b + root) / twoA, single));
+    x[1] = select(two & ~linear, (-b - root) / twoA, nan);
+}
+
+/* solveCubicNormed of the scalar kernels for a uniform a; missing roots are NaN */
+template <class V>
+static inline void solveCubicNormedLanes(V x[3], float a, V b, V c) {
+    const V nan = V::set(std::numeric_limits<float>::quiet_NaN());
+    float a2 = a * a;
+    V q = V::set(float(1 / 9.)) * (V::set(a2) - V::set(3) * b);
+    V r = V::set(float(1 / 54.)) * (V::set(a) * (V::set(2 * a2) - V::set(9) * b) + V::set(27) * c);
+    V r2 = r * r;
+    V q3 = q * q * q;
+    V a3 = V::set(a * float(1 / 3.));
+
+    // Three real roots: cos((t + k tau)/3) for k = 1, -1 follow from the angle sum identities
+    typename V::Mask three = r2 < q3;
+    V t = r / vsqrt(q3);
+    t = select(t < V::set(-1), V::set(-1), select(t > V::set(1), V::set(1), t));
+    V sinT, cosT;
+    sinCosLanes(V::set(float(1 / 3.)) * acosLanes(t), sinT, cosT);
+    V scale = V::set(-2) * vsqrt(q);
+    V halfCos = V::set(-.5f) * cosT, halfSin = V::set(float(0.8660254037844386)) * sinT;
+    V root0 = scale * cosT - a3;
+    V root1 = scale * (halfCos - halfSin) - a3;
+    V root2 = scale * (halfCos + halfSin) - a3;
+
+    // One real root, or two where they coincide
+    V u = cbrtLanes(vabs(r) + vsqrt(r2 - q3));
+    u = select(r < V::set(0), u, -u);
+    V v = select(u == V::set(0), V::set(0), q / u);
+    typename V::Mask doubled = (u == v) | (vabs(u - v) < V::set(SolverLimits<float>::doubleRoot) * vabs(u + v));
+    x[0] = select(three, root0, (u + v) - a3);
+    x[1] = select(three, root1, select(doubled, V::set(-.5f) * (u + v) - a3, nan));
+    x[2] = select(three, root2, nan);
+}
+
+template <class V>
+static inline PacketDistance<V> linearLanes(const FlatEdge<float>& edge, V x, V y) {
+    float abx = edge.x[1] - edge.x[0], aby = edge.y[1] - edge.y[0];
+    bool collapsed = abx == 0 && aby == 0;
+    float dirX = collapsed ? edge.directionX : abx, dirY = collapsed ? edge.directionY : aby;
+    V aqx = x - V::set(edge.x[0]), aqy = y - V::set(edge.y[0]);
+    V param = (aqx * V::set(dirX) + aqy * V::set(dirY)) / V::set(abx * abx + aby * aby);
+    typename V::Mask far = param > V::set(.5f);
+    V eqx = select(far, V::set(edge.x[1]), V::set(edge.x[0])) - x;
+    V eqy = select(far, V::set(edge.y[1]), V::set(edge.y[0])) - y;
+    V endpointDistance = vsqrt(eqx * eqx + eqy * eqy);
+
+    float len = std::sqrt(abx * abx + aby * aby);
+    float orthoX = len == 0 ? 0.0f : aby / len, orthoY = len == 0 ? -1.0f : -abx / len;
+    V orthoDistance = V::set(orthoX) * aqx + V::set(orthoY) * aqy;
+    typename V::Mask ortho = (param > V::set(0)) & (param < V::set(1)) & (vabs(orthoDistance) < endpointDistance);
+
+    V cross = aqx * V::set(dirY) - aqy * V::set(dirX);
+    normalize(dirX, dirY);
+    normalizeLanes(eqx, eqy);
+    V endpointDot = vabs(V::set(dirX) * eqx + V::set(dirY) * eqy);
+    return {select(ortho, orthoDistance, signedBy(cross, endpointDistance)), select(ortho, V::set(0), endpointDot), param};
+}
+
+template <class V>
+static inline PacketDistance<V> quadraticLanes(const FlatEdge<float>& edge, V x, V y) {
+    float abx = edge.x[1] - edge.x[0], aby = edge.y[1] - edge.y[0];
+    float brx = edge.x[2] - edge.x[1] - abx, bry = edge.y[2] - edge.y[1] - aby;
+    V qax = V::set(edge.x[0]) - x, qay = V::set(edge.y[0]) - y;
+    float a = brx * brx + bry * bry;
+    float b = 3 * (abx * brx + aby * bry);
+    V c = V::set(2 * (abx * abx + aby * aby)) + (qax * V::set(brx) + qay * V::set(bry));
+    V d = qax * V::set(abx) + qay * V::set(aby);
+    V t[3];
+    float bn = a != 0 ? b / a : 0;
+    if (a != 0 && std::fabs(bn) < SolverLimits<float>::quadraticRatio) {
+        solveCubicNormedLanes(t, bn, c / V::set(a), d / V::set(a));
+    } else {
+        solveQuadraticLanes(t, b, c, d);
+    }
+
+    float startX = abx, startY = aby, endX = edge.x[2] - edge.x[1], endY = edge.y[2] - edge.y[1];
+    if (startX == 0 && startY == 0) startX = edge.x[2] - edge.x[0], startY = edge.y[2] - edge.y[0];
+    if (endX == 0 && endY == 0) endX = edge.x[2] - edge.x[0], endY = edge.y[2] - edge.y[0];
+
+    V minDistance = signedBy(V::set(startX) * qay - V::set(startY) * qax, vsqrt(qax * qax + qay * qay));
+    V param = -(qax * V::set(startX) + qay * V::set(startY)) / V::set(startX * startX + startY * startY);
+    V bqx = V::set(edge.x[2]) - x, bqy = V::set(edge.y[2]) - y;
+    V endDistance = vsqrt(bqx * bqx + bqy * bqy);
+    typename V::Mask nearEnd = endDistance < vabs(minDistance);
+    minDistance = select(nearEnd, signedBy(V::set(endX) * bqy - V::set(endY) * bqx, endDistance), minDistance);
+    V endParam = ((x - V::set(edge.x[1])) * V::set(endX) + (y - V::set(edge.y[1])) * V::set(endY)) / V::set(endX * endX + endY * endY);
+    param = select(nearEnd, endParam, param);
+    for (int i = 0; i < 3; i++) {
+        V twoT = V::set(2) * t[i], tt = t[i] * t[i];
+        V qex = qax + twoT * V::set(abx) + tt * V::set(brx);
+        V qey = qay + twoT * V::set(aby) + tt * V::set(bry);
+        V distance = vsqrt(qex * qex + qey * qey);
+        typename V::Mask closer = (t[i] > V::set(0)) & (t[i] < V::set(1)) & (distance <= vabs(minDistance));
+        V tangentX = V::set(abx) + t[i] * V::set(brx), tangentY = V::set(aby) + t[i] * V::set(bry);
+        minDistance = select(closer, signedBy(tangentX * qey - tangentY * qex, distance), minDistance);
+        param = select(closer, t[i], param);
+    }
+
+    normalize(startX, startY);
+    normalize(endX, endY);
+    normalizeLanes(qax, qay);
+    normalizeLanes(bqx, bqy);
+    V startDot = vabs(V::set(startX) * qax + V::set(startY) * qay);
+    V endDot = vabs(V::set(endX) * bqx + V::set(endY) * bqy);
+    typename V::Mask onSegment = (param >= V::set(0)) & (param <= V::set(1));
+    return {minDistance, select(onSegment, V::set(0), select(param < V::set(.5f), startDot, endDot)), param};
+}
+
+/* Bounds of an edge's control points, which contain the segment */
+struct EdgeBox {
+    float l, b, r, t;
+};
+
+/* Squared distance from the box to the nearest point of the span between left and right at y */
+static inline float boxDistanceSquared(const EdgeBox& box, float left, float right, float y) {
+    float dx = std::max(std::max(box.l - right, left - box.r), 0.0f);
+    float dy = std::max(std::max(box.b - y, y - box.t), 0.0f);
+    return dx * dx + dy * dy;
+}
+
+/*
+ * Distances of the lanes to the edge. Cubic segments go through the scalar kernel,
+ * which skips the lanes where the edge's bounds are farther than limit; those get
+ * a distance of FLT_MAX.
+ */
+template <class V>
+static inline PacketDistance<V> edgeLanes(const FlatEdge<float>& edge, const EdgeBox& box, V x, V y, V limit) {
+    switch (edge.pointCount) {
+        case 2: return linearLanes(edge, x, y);
+        case 3: return quadraticLanes(edge, x, y);
+    }
+    const V zero = V::set(0);
+    V dx = select(V::set(box.l) - x > zero, V::set(box.l) - x, select(x - V::set(box.r) > zero, x - V::set(box.r), zero));
+    V dy = select(V::set(box.b) - y > zero, V::set(box.b) - y, select(y - V::set(box.t) > zero, y - V::set(box.t), zero));
+    float xs[V::width], ys[V::width], reach[V::width], limits[V::width];
+    float distances[V::width], dots[V::width], params[V::width];
+    x.store(xs);
+    y.store(ys);
+    (dx * dx + dy * dy).store(reach);
+    (limit * limit).store(limits);
+    for (int i = 0; i < V::width; i++) {
+        if (reach[i] > limits[i]) {
+            distances[i] = FLT_MAX, dots[i] = 0, params[i] = 0;
+            continue;
+        }
+        FlatDistance<float> distance = edgeDistance(edge, xs[i], ys[i], params[i]);
+        distances[i] = distance.distance;
+        dots[i] = distance.dot;
+    }
+    return {V::load(distances), V::load(dots), V::load(params)};
+}
+
+/* ============================================================================
+ * Row kernels
+ * ============================================================================ */
+
+/* Lanes where distance a is less than distance b in the order of FlatDistance */
+template <class V>
+static inline typename V::Mask lessLanes(V aDistance, V aDot, V bDistance, V bDot) {
+    V absA = vabs(aDistance), absB = vabs(bDistance);
+    return (absA < absB) | ((absA == absB) & (aDot < bDot));
+}
+
+struct RowContext {
+    const FlatEdge<float>* edges;
+    const EdgeBox* boxes;
+    int edgeCount;
+    const float* columns;   /* Local x of every column, padded with the last one to whole packets */
+    int width;
+};
+
+typedef unsigned long long (*RowKernel)(const RowContext& context, float y, float* distances);
+
+/*
+ * Stores the signed distance of every pixel of the row at local y into distances.
+ * Per lane, the result is the least distance in the order of FlatDistance, with
+ * ties going to the edge that comes first, as in the scalar generator.
+ */
+template <class V>
+static unsigned long long evaluateRow(const RowContext& context, float y, float* distances) {
+    typedef typename V::Mask Mask;
+    const V py = V::set(y);
+    unsigned long long evaluations = 0;
+    int hint = 0;
+    for (int x0 = 0; x0 < context.width; x0 += V::width) {
+        int lanes = std::min(V::width, context.width - x0);
+        V px = V::load(context.columns + x0);
+        float left = std::min(context.columns[x0], context.columns[x0 + lanes - 1]);
+        float right = std::max(context.columns[x0], context.columns[x0 + lanes - 1]);
+        V bestDistance = V::set(-FLT_MAX), bestDot = V::set(0), bestIndex = V::set(0);
+        float limit = FLT_MAX;
+        for (int k = 0; k < context.edgeCount; k++) {
+            // The previous packet's nearest edge goes first to tighten the limit early
+            int i = k == 0 ? hint : k <= hint ? k - 1 : k;
+            if (boxDistanceSquared(context.boxes[i], left, right, y) > limit * limit) continue;
+
+            V laneLimit = vabs(bestDistance) * V::set(1 + MSDFGEN_C_PACKET_CULL_SLACK);
+            PacketDistance<V> distance = edgeLanes(context.edges[i], context.boxes[i], px, py, laneLimit);
+            evaluations += lanes;
+            V index = V::set(float(i));
+            Mask tie = (vabs(distance.distance) == vabs(bestDistance)) & (distance.dot == bestDot);
+            Mask better = lessLanes(distance.distance, distance.dot, bestDistance, bestDot) | (tie & (index < bestIndex));
+            bestDistance = select(better, distance.distance, bestDistance);
+            bestDot = select(better, distance.dot, bestDot);
+            bestIndex = select(better, index, bestIndex);
+            limit = hmax(vabs(bestDistance)) * (1 + MSDFGEN_C_PACKET_CULL_SLACK);
+        }
+        float packet[V::width];
+        bestIndex.store(packet);
+        hint = static_cast<int>(packet[0]);
+        bestDistance.store(packet);
+        std::copy(packet, packet + lanes, distances + x0);
+    }
+    return evaluations;
+}
+
+/* ============================================================================
+ * Selector kernels
+ * ============================================================================ */
+
+/*
+ * What msdfgen's perpendicular distance selectors use of an edge besides its
+ * distance: its end points, its tangents there and their bisectors with the
+ * tangents of the neighboring edges, normalized with allowZero, and the unit
+ * tangents of EdgeSegment::distanceToPerpendicularDistance, normalized without.
+ * All are computed in double and rounded once.
+ */
+struct EdgeEnds {
+    float startX, startY, endX, endY;
+    float startTangentX, startTangentY, endTangentX, endTangentY;
+    float startBisectorX, startBisectorY, endBisectorX, endBisectorY;
+    float startUnitX, startUnitY, endUnitX, endUnitY;
+};
+
+/* One channel of msdfgen's PerpendicularDistanceSelectorBase at one pixel */
+struct PerpendicularChannel {
+    FlatDistance<float> trueDistance;
+    int edge = -1;                  /* Edge of the true distance, or -1 */
+    float param = 0;                /* Segment parameter of its nearest point */
+    float negative = -FLT_MAX;      /* Nearest perpendicular distances on either side */
+    float positive = FLT_MAX;
+
+    void merge(const PerpendicularChannel& other) {
+        if (other.trueDistance < trueDistance) {
+            trueDistance = other.trueDistance;
+            edge = other.edge;
+            param = other.param;
+        }
+        negative = std::max(negative, other.negative);
+        positive = std::min(positive, other.positive);
+    }
+
+    /* computeDistance: the perpendicular distance of the nearest edge's extension, unless one past another edge's end is nearer */
+    float distance(const EdgeEnds* ends, float x, float y) const {
+        float minDistance = trueDistance.distance < 0 ? negative : positive;
+        if (edge >= 0) {
+            const EdgeEnds& e = ends[edge];
+            float distance = trueDistance.distance;
+            if (param < 0) {
+                float aqx = x - e.startX, aqy = y - e.startY;
+                if (aqx * e.startUnitX + aqy * e.startUnitY < 0) {
+                    float perpendicular = aqx * e.startUnitY - aqy * e.startUnitX;
+                    if (std::fabs(perpendicular) <= std::fabs(distance)) distance = perpendicular;
+                }
+            } else if (param > 1) {
+                float bqx = x - e.endX, bqy = y - e.endY;
+                if (bqx * e.endUnitX + bqy * e.endUnitY > 0) {
+                    float perpendicular = bqx * e.endUnitY - bqy * e.endUnitX;
+                    if (std::fabs(perpendicular) <= std::fabs(distance)) distance = perpendicular;
+                }
+            }
+            if (std::fabs(distance) < std::fabs(minDistance)) {
+                minDistance = distance;
+            }
+        }
+        return minDistance;
+    }
+};
+
+/* msdfgen's TrueDistanceSelector at one pixel */
+struct TrueSelector {
+    typedef float Distance;
+    FlatDistance<float> trueDistance;
+
+    void merge(const TrueSelector& other) {
+        if (other.trueDistance < trueDistance) {
+            trueDistance = other.trueDistance;
+        }
+    }
+
+    float distance(const EdgeEnds*, float, float) const {
+        return trueDistance.distance;
+    }
+
+    static float resolve(float distance) {
+        return distance;
+    }
+};
+
+/* MultiAndTrueDistance; MSDF leaves out a */
+struct MultiDistance {
+    float r, g, b, a;
+};
+
+/* msdfgen's MultiDistanceSelector at one pixel, which also gives the true distance of MultiAndTrueDistanceSelector */
+struct MultiSelector {
+    typedef MultiDistance Distance;
+    PerpendicularChannel channels[3];
+
+    void merge(const MultiSelector& other) {
+        for (int i = 0; i < 3; i++) {
+            channels[i].merge(other.channels[i]);
+        }
+    }
+
+    MultiDistance distance(const EdgeEnds* ends, float x, float y) const {
+        FlatDistance<float> trueDistance = channels[0].trueDistance;
+        for (int i = 1; i < 3; i++) {
+            if (channels[i].trueDistance < trueDistance) {
+                trueDistance = channels[i].trueDistance;
+            }
+        }
+        return {channels[0].distance(ends, x, y), channels[1].distance(ends, x, y), channels[2].distance(ends, x, y), trueDistance.distance};
+    }
+
+    static float resolve(const MultiDistance& distance) {
+        return median(distance.r, distance.g, distance.b);
+    }
+};
+
+static inline void storeDistance(float distance, float* values, int) {
+    values[0] = distance;
+}
+
+static inline void storeDistance(const MultiDistance& distance, float* values, int channels) {
+    values[0] = distance.r, values[1] = distance.g, values[2] = distance.b;
+    if (channels > 3) {
+        values[3] = distance.a;
+    }
+}
+
+enum SelectorKind {
+    SELECT_TRUE_DISTANCE,   /* TrueSelector, for SDF */
+    SELECT_MULTI_DISTANCE   /* MultiSelector, for MSDF and MTSDF */
+};
+
+struct SelectorRowContext {
+    const FlatEdge<float>* edges;
+    const EdgeBox* boxes;
+    const EdgeEnds* ends;
+    const int* groupEnds;   /* One past the last edge of each group: every contour with overlap support, otherwise the whole shape */
+    const int* groupColors; /* Channels that the edges of each group have between them */
+    const int* windings;    /* Winding of each contour, with overlap support */
+    int groupCount;
+    bool overlapSupport;
+    SelectorKind kind;
+    int channels;           /* Values stored per pixel */
+    const float* columns;   /* Local x of every column, padded with the last one to whole packets */
+    int width;
+};
+
+/* The selectors of every group of one pixel in a packet, and the distances of those groups */
+struct SelectorScratch {
+    std::vector<TrueSelector> trueSelectors;
+    std::vector<float> trueDistances;
+    std::vector<MultiSelector> multiSelectors;
+    std::vector<MultiDistance> multiDistances;
+};
+
+typedef unsigned long long (*SelectorRowKernel)(const SelectorRowContext& context, float y, float* values, SelectorScratch& scratch);
+
+/* Pixels of a packet and the span of columns they cover */
+template <class V>
+struct PacketLanes {
+    V x, y;
+    float left, right, row;
+    int lanes;
+};
+
+/* Least distance of the group's edges per lane, stored into the selectors of lane i at selectors[i * stride] */
+template <class V>
+static unsigned long long selectGroup(const SelectorRowContext& context, int first, int last, int, const PacketLanes<V>& packet, TrueSelector* selectors, int stride) {
+    V bestDistance = V::set(-FLT_MAX), bestDot = V::set(0);
+    float limit = FLT_MAX;
+    unsigned long long evaluations = 0;
+    for (int i = first; i < last; i++) {
+        if (boxDistanceSquared(context.boxes[i], packet.left, packet.right, packet.row) > limit * limit) continue;
+        V laneLimit = vabs(bestDistance) * V::set(1 + MSDFGEN_C_PACKET_CULL_SLACK);
+        PacketDistance<V> distance = edgeLanes(context.edges[i], context.boxes[i], packet.x, packet.y, laneLimit);
+        evaluations += packet.lanes;
+        typename V::Mask closer = lessLanes(distance.distance, distance.dot, bestDistance, bestDot);
+        bestDistance = select(closer, distance.distance, bestDistance);
+        bestDot = select(closer, distance.dot, bestDot);
+        limit = hmax(vabs(bestDistance)) * (1 + MSDFGEN_C_PACKET_CULL_SLACK);
+    }
+    float distances[V::width], dots[V::width];
+    bestDistance.store(distances);
+    bestDot.store(dots);
+    for (int lane = 0; lane < packet.lanes; lane++) {
+        selectors[lane * stride].trueDistance = FlatDistance<float>(distances[lane], dots[lane]);
+    }
+    return evaluations;
+}
+
+/* PerpendicularDistanceSelectorBase of one channel across the lanes */
+template <class V>
+struct ChannelLanes {
+    V distance, dot;
+    V edge, param;
+    V negative, positive;
+};
+
+/* addEdgeTrueDistance */
+template <class V>
+static inline void addTrueDistance(ChannelLanes<V>& channel, const PacketDistance<V>& distance, V edge) {
+    typename V::Mask closer = lessLanes(distance.distance, distance.dot, channel.distance, channel.dot);
+    channel.distance = select(closer, distance.distance, channel.distance);
+    channel.dot = select(closer, distance.dot, channel.dot);
+    channel.edge = select(closer, edge, channel.edge);
+    channel.param = select(closer, distance.param, channel.param);
+}
+
+/* addEdgePerpendicularDistance of the lanes in mask */
+template <class V>
+static inline void addPerpendicularDistance(ChannelLanes<V>& channel, typename V::Mask mask, V distance) {
+    const V zero = V::set(0);
+    channel.negative = select(mask & (distance <= zero) & (distance > channel.negative), distance, channel.negative);
+    channel.positive = select(mask & (distance >= zero) & (distance < channel.positive), distance, channel.positive);
+}
+
+/*
+ * MultiDistanceSelector::addEdge for each of the group's edges across the lanes,
+ * storing the channels of lane i into the selectors at selectors[i * stride].
+ * Edges whose bounds are farther than the true distances of all of the group's
+ * channels cannot change those, so only their perpendicular distances are added.
+ * That skips msdfgen's check that they are nearer than the edge itself, which can
+ * only fail where they are also farther than the true distance of their channel,
+ * and computeDistance never picks such a distance.
+ */
+template <class V>
+static unsigned long long selectGroup(const SelectorRowContext& context, int first, int last, int colors, const PacketLanes<V>& packet, MultiSelector* selectors, int stride) {
+    typedef typename V::Mask Mask;
+    const V zero = V::set(0);
+    ChannelLanes<V> channels[3];
+    for (ChannelLanes<V>& channel : channels) {
+        channel = {V::set(-FLT_MAX), zero, V::set(-1), zero, V::set(-FLT_MAX), V::set(FLT_MAX)};
+    }
+    V laneLimit = V::set(FLT_MAX);
+    float limit = FLT_MAX;
+    unsigned long long evaluations = 0;
+    for (int i = first; i < last; i++) {
+        const FlatEdge<float>& edge = context.edges[i];
+        int color = edge.color & WHITE;
+        if (!color) continue;
+        const EdgeEnds& ends = context.ends[i];
+
+        // Perpendicular distances past an end count where the pixel lies beyond it and on the edge's side of the bisector with the neighbor
+        V apx = packet.x - V::set(ends.startX), apy = packet.y - V::set(ends.startY);
+        V bpx = packet.x - V::set(ends.endX), bpy = packet.y - V::set(ends.endY);
+        V startDomain = apx * V::set(ends.startBisectorX) + apy * V::set(ends.startBisectorY);
+        V endDomain = -(bpx * V::set(ends.endBisectorX) + bpy * V::set(ends.endBisectorY));
+        V startPerpendicular = apx * V::set(ends.startTangentY) - apy * V::set(ends.startTangentX);
+        V endPerpendicular = bpx * V::set(ends.endTangentY) - bpy * V::set(ends.endTangentX);
+        Mask startBeyond = (startDomain > zero) & (apx * V::set(ends.startTangentX) + apy * V::set(ends.startTangentY) < zero);
+        Mask endBeyond = (endDomain > zero) & (bpx * V::set(ends.endTangentX) + bpy * V::set(ends.endTangentY) > zero);
+
+        if (boxDistanceSquared(context.boxes[i], packet.left, packet.right, packet.row) <= limit * limit) {
+            PacketDistance<V> distance = edgeLanes(edge, context.boxes[i], packet.x, packet.y, laneLimit);
+            evaluations += packet.lanes;
+            V absDistance = vabs(distance.distance);
+            startBeyond = startBeyond & (vabs(startPerpendicular) < absDistance);
+            endBeyond = endBeyond & (vabs(endPerpendicular) < absDistance);
+            V index = V::set(float(i));
+            V farthest = zero;
+            for (int c = 0; c < 3; c++) {
+                if (color & (1 << c)) {
+                    addTrueDistance(channels[c], distance, index);
+                }
+                if (colors & (1 << c)) {
+                    V channelDistance = vabs(channels[c].distance);
+                    farthest = select(channelDistance > farthest, channelDistance, farthest);
+                }
+            }
+            laneLimit = farthest * V::set(1 + MSDFGEN_C_PACKET_CULL_SLACK);
+            limit = hmax(laneLimit);
+        }
+        for (int c = 0; c < 3; c++) {
+            if (color & (1 << c)) {
+                addPerpendicularDistance(channels[c], startBeyond, startPerpendicular);
+                addPerpendicularDistance(channels[c], endBeyond, endPerpendicular);
+            }
+        }
+    }
+
+    for (int c = 0; c < 3; c++) {
+        float distances[V::width], dots[V::width], edges[V::width], params[V::width], negatives[V::width], positives[V::width];
+        channels[c].distance.store(distances);
+        channels[c].dot.store(dots);
+        channels[c].edge.store(edges);
+        channels[c].param.store(params);
+        channels[c].negative.store(negatives);
+        channels[c].positive.store(positives);
+        for (int lane = 0; lane < packet.lanes; lane++) {
+            PerpendicularChannel& channel = selectors[lane * stride].channels[c];
+            channel.trueDistance = FlatDistance<float>(distances[lane], dots[lane]);
+            channel.edge = static_cast<int>(edges[lane]);
+            channel.param = params[lane];
+            channel.negative = negatives[lane];
+            channel.positive = positives[lane];
+        }
+    }
+    return evaluations;
+}
+
+/*
+ * Stores the distances of every pixel of the row at local y into values, as the
+ * selectors of msdfgen's ShapeDistanceFinder would give them with a
+ * SimpleContourCombiner, or with overlap support, an OverlappingContourCombiner.
+ */
+template <class V, class Selector>
+static unsigned long long selectRow(const SelectorRowContext& context, float y, float* values, Selector* selectors, typename Selector::Distance* contourDistances) {
+    const int groupCount = context.groupCount;
+    unsigned long long evaluations = 0;
+    for (int x0 = 0; x0 < context.width; x0 += V::width) {
+        PacketLanes<V> packet;
+        packet.lanes = std::min(V::width, context.width - x0);
+        packet.x = V::load(context.columns + x0);
+        packet.y = V::set(y);
+        packet.left = std::min(context.columns[x0], context.columns[x0 + packet.lanes - 1]);
+        packet.right = std::max(context.columns[x0], context.columns[x0 + packet.lanes - 1]);
+        packet.row = y;
+        int first = 0;
+        for (int group = 0; group < groupCount; group++) {
+            evaluations += selectGroup(context, first, context.groupEnds[group], context.groupColors[group], packet, selectors + group, groupCount);
+            first = context.groupEnds[group];
+        }
+        for (int lane = 0; lane < packet.lanes; lane++) {
+            const Selector* pixel = selectors + lane * groupCount;
+            float x = context.columns[x0 + lane];
+            typename Selector::Distance distance = context.overlapSupport
+                ? combineOverlapping(pixel, context.windings, groupCount, contourDistances, context.ends, x, y)
+                : pixel->distance(context.ends, x, y);
+            storeDistance(distance, values + static_cast<size_t>(x0 + lane) * context.channels, context.channels);
+        }
+    }
+    return evaluations;
+}
+
+template <class V>
+static unsigned long long evaluateSelectorRow(const SelectorRowContext& context, float y, float* values, SelectorScratch& scratch) {
+    if (context.kind == SELECT_TRUE_DISTANCE) {
+        return selectRow<V>(context, y, values, scratch.trueSelectors.data(), scratch.trueDistances.data());
+    }
+    return selectRow<V>(context, y, values, scratch.multiSelectors.data(), scratch.multiDistances.data());
+}
+
+/* ============================================================================
+ * Kernel selection
+ * ============================================================================ */
+
+#ifdef MSDFGEN_C_X86
+
+MSDFGEN_C_TARGET("avx2") MSDFGEN_C_FLATTEN
+static unsigned long long evaluateRowAvx2(const RowContext& context, float y, float* distances) {
+    return evaluateRow<Avx2Float>(context, y, distances);
+}
+
+MSDFGEN_C_TARGET("avx2") MSDFGEN_C_FLATTEN
+static unsigned long long evaluateSelectorRowAvx2(const SelectorRowContext& context, float y, float* values, SelectorScratch& scratch) {
+    return evaluateSelectorRow<Avx2Float>(context, y, values, scratch);
+}
+
+MSDFGEN_C_TARGET("avx512f") MSDFGEN_C_FLATTEN
+static unsigned long long evaluateRowAvx512(const RowContext& context, float y, float* distances) {
+    return evaluateRow<Avx512Float>(context, y, distances);
+}
+
+MSDFGEN_C_TARGET("avx512f") MSDFGEN_C_FLATTEN
+static unsigned long long evaluateSelectorRowAvx512(const SelectorRowContext& context, float y, float* values, SelectorScratch& scratch) {
+    return evaluateSelectorRow<Avx512Float>(context, y, values, scratch);
+}
+
+#elif defined(MSDFGEN_C_NEON)
+
+static unsigned long long evaluateRowNeon(const RowContext& context, float y, float* distances) {
+    return evaluateRow<NeonFloat>(context, y, distances);
+}
+
+static unsigned long long evaluateSelectorRowNeon(const SelectorRowContext& context, float y, float* values, SelectorScratch& scratch) {
+    return evaluateSelectorRow<NeonFloat>(context, y, values, scratch);
+}
+
+#endif
+
+static unsigned long long evaluateSelectorRowScalar(const SelectorRowContext& context, float y, float* values, SelectorScratch& scratch) {
+    return evaluateSelectorRow<ScalarFloat>(context, y, values, scratch);
+}
+
+struct RowKernelChoice {
+    RowKernel kernel;
+    SelectorRowKernel selectorKernel;
+    int width;
+};
+
+static RowKernelChoice selectRowKernel() {
+#ifdef MSDFGEN_C_X86
+    switch (detectInstructionSet()) {
+        case ISA_AVX512: return {evaluateRowAvx512, evaluateSelectorRowAvx512, Avx512Float::width};
+        case ISA_AVX2: return {evaluateRowAvx2, evaluateSelectorRowAvx2, Avx2Float::width};
+        default: break;
+    }
+#elif defined(MSDFGEN_C_NEON)
+    return {evaluateRowNeon, evaluateSelectorRowNeon, NeonFloat::width};
+#endif
+    return {nullptr, evaluateSelectorRowScalar, 0};
+}
+
+static const RowKernelChoice& rowKernel() {
+    static const RowKernelChoice choice = selectRowKernel();
+    return choice;
+}
+
+int distancePacketWidth() {
+    return rowKernel().width;
+}
+
+/* ============================================================================
+ * Generators
+ * ============================================================================ */
+
+static std::vector<EdgeBox> edgeBoxes(const FlatShape<float>& flat) {
+    std::vector<EdgeBox> boxes;
+    boxes.reserve(flat.edges.size());
+    for (const FlatEdge<float>& edge : flat.edges) {
+        EdgeBox box = {edge.x[0], edge.y[0], edge.x[0], edge.y[0]};
+        for (int i = 1; i < edge.pointCount; i++) {
+            box.l = std::min(box.l, edge.x[i]), box.b = std::min(box.b, edge.y[i]);
+            box.r = std::max(box.r, edge.x[i]), box.t = std::max(box.t, edge.y[i]);
+        }
+        boxes.push_back(box);
+    }
+    return boxes;
+}
+
+static std::vector<EdgeEnds> edgeEnds(const Shape& shape, const FlatShape<float>& flat) {
+    // Directions are taken from the segments in double and rounded once, as a float copy
+    // of a very short edge can collapse to a point and lose the direction msdfgen uses
+    std::vector<Vector2> startTangents, endTangents;
+    std::vector<EdgeEnds> ends;
+    ends.reserve(flat.edges.size());
+    for (const Contour& contour : shape.contours) {
+        for (size_t i = 0; i < contour.edges.size(); i++) {
+            const EdgeSegment* segment = visitedEdge(contour, i);
+            int pointCount;
+            if (!segmentPoints(segment, pointCount)) continue;
+            const FlatEdge<float>& edge = flat.edges[ends.size()];
+            int last = edge.pointCount - 1;
+            EdgeEnds e;
+            e.startX = edge.x[0], e.startY = edge.y[0];
+            e.endX = edge.x[last], e.endY = edge.y[last];
+            Vector2 startDirection = segment->direction(0), endDirection = segment->direction(1);
+            startTangents.push_back(startDirection.normalize(true));
+            endTangents.push_back(endDirection.normalize(true));
+            Vector2 startUnit = startDirection.normalize(), endUnit = endDirection.normalize();
+            e.startTangentX = float(startTangents.back().x), e.startTangentY = float(startTangents.back().y);
+            e.endTangentX = float(endTangents.back().x), e.endTangentY = float(endTangents.back().y);
+            e.startUnitX = float(startUnit.x), e.startUnitY = float(startUnit.y);
+            e.endUnitX = float(endUnit.x), e.endUnitY = float(endUnit.y);
+            ends.push_back(e);
+        }
+    }
+    // The neighbors are those within the contour, which wraps around
+    int first = 0;
+    for (int end : flat.contourEnds) {
+        for (int i = first; i < end; i++) {
+            int prev = i == first ? end - 1 : i - 1;
+            int next = i + 1 == end ? first : i + 1;
+            Vector2 startBisector = (endTangents[prev] + startTangents[i]).normalize(true);
+            Vector2 endBisector = (endTangents[i] + startTangents[next]).normalize(true);
+            EdgeEnds& e = ends[i];
+            e.startBisectorX = float(startBisector.x), e.startBisectorY = float(startBisector.y);
+            e.endBisectorX = float(endBisector.x), e.endBisectorY = float(endBisector.y);
+        }
+        first = end;
+    }
+    return ends;
+}
+
+/* Local x of the center of every column, padded with the last one to a multiple of the widest packet */
+static std::vector<float> packetColumns(const FlatShape<float>& flat, const SDFTransformation& transformation, int width) {
+    int paddedWidth = (width + MSDFGEN_C_MAX_PACKET_WIDTH - 1) / MSDFGEN_C_MAX_PACKET_WIDTH * MSDFGEN_C_MAX_PACKET_WIDTH;
+    std::vector<float> columns(paddedWidth);
+    for (int x = 0; x < paddedWidth; x++) {
+        columns[x] = flat.localX(transformation.unprojectX(std::min(x, width - 1) + .5));
+    }
+    return columns;
+}
+
+/* Runs the selector kernel over every row: true distances for N = 1, multi-channel distances for N = 3 and 4 */
+template <int N>
+static unsigned long long generateSelectorPackets(const BitmapRef<float, N>& output, const Shape& shape, const SDFTransformation& transformation, bool overlapSupport) {
+    if (output.width <= 0) return 0;
+    SelectorRowKernel kernel = rowKernel().selectorKernel;
+
+    FlatShape<float> flat(shape);
+    std::vector<EdgeBox> boxes = edgeBoxes(flat);
+    std::vector<EdgeEnds> ends = edgeEnds(shape, flat);
+    std::vector<float> columns = packetColumns(flat, transformation, output.width);
+    std::vector<int> groupEnds = overlapSupport ? flat.contourEnds : std::vector<int>(1, static_cast<int>(flat.edges.size()));
+    std::vector<int> groupColors;
+    int first = 0;
+    for (int end : groupEnds) {
+        int colors = 0;
+        for (int i = first; i < end; i++) {
+            colors |= flat.edges[i].color;
+        }
+        groupColors.push_back(colors & WHITE);
+        first = end;
+    }
+    SelectorRowContext context = {
+        flat.edges.data(), boxes.data(), ends.data(),
+        groupEnds.data(), groupColors.data(), flat.windings.data(), static_cast<int>(groupEnds.size()),
+        overlapSupport, N == 1 ? SELECT_TRUE_DISTANCE : SELECT_MULTI_DISTANCE, N,
+        columns.data(), output.width
+    };
+
+    bool inverseYAxis = shape.getYAxisOrientation() == Y_DOWNWARD;
+    size_t selectorCount = groupEnds.size() * MSDFGEN_C_MAX_PACKET_WIDTH;
+    unsigned long long evaluations = 0;
+#ifdef MSDFGEN_USE_OPENMP
+    #pragma omp parallel reduction(+:evaluations)
+#endif
+    {
+        SelectorScratch scratch;
+        if (N == 1) {
+            scratch.trueSelectors.resize(selectorCount);
+            scratch.trueDistances.resize(groupEnds.size());
+        } else {
+            scratch.multiSelectors.resize(selectorCount);
+            scratch.multiDistances.resize(groupEnds.size());
+        }
+        std::vector<float> values(static_cast<size_t>(output.width) * N);
+#ifdef MSDFGEN_USE_OPENMP
+        #pragma omp for
+#endif
+        for (int y = 0; y < output.height; y++) {
+            int row = inverseYAxis ? output.height - y - 1 : y;
+            evaluations += kernel(context, flat.localY(transformation.unprojectY(y + .5)), values.data(), scratch);
+            for (int x = 0; x < output.width; x++) {
+                float* pixel = output(x, row);
+                for (int i = 0; i < N; i++) {
+                    pixel[i] = float(transformation.distanceMapping(double(values[N * x + i])));
+                }
+            }
+        }
+    }
+    return evaluations;
+}
+
+unsigned long long generateSDFPackets(const BitmapRef<float, 1>& output, const Shape& shape, const SDFTransformation& transformation, bool overlapSupport) {
+    if (overlapSupport) {
+        return generateSelectorPackets(output, shape, transformation, true);
+    }
+    const RowKernelChoice& kernel = rowKernel();
+    if (!kernel.kernel || output.width <= 0) return 0;
+
+    FlatShape<float> flat(shape);
+    std::vector<EdgeBox> boxes = edgeBoxes(flat);
+    std::vector<float> columns = packetColumns(flat, transformation, output.width);
+    RowContext context = {flat.edges.data(), boxes.data(), static_cast<int>(flat.edges.size()), columns.data(), output.width};
+
+    bool inverseYAxis = shape.getYAxisOrientation() == Y_DOWNWARD;
+    unsigned long long evaluations = 0;
+#ifdef MSDFGEN_USE_OPENMP
+    #pragma omp parallel reduction(+:evaluations)
+#endif
+    {
+        std::vector<float> distances(output.width);
+#ifdef MSDFGEN_USE_OPENMP
+        #pragma omp for
+#endif
+        for (int y = 0; y < output.height; y++) {
+            int row = inverseYAxis ? output.height - y - 1 : y;
+            evaluations += kernel.kernel(context, flat.localY(transformation.unprojectY(y + .5)), distances.data());
+            for (int x = 0; x < output.width; x++) {
+                *output(x, row) = float(transformation.distanceMapping(double(distances[x])));
+            }
+        }
+    }
+    return evaluations;
+}
+
+unsigned long long generateMSDFPackets(const BitmapRef<float, 3>& output, const Shape& shape, const SDFTransformation& transformation, bool overlapSupport) {
+    return generateSelectorPackets(output, shape, transformation, overlapSupport);
+}
+
+unsigned long long generateMTSDFPackets(const BitmapRef<float, 4>& output, const Shape& shape, const SDFTransformation& transformation, bool overlapSupport) {
+    return generateSelectorPackets(output, shape, transformation, overlapSupport);
+}
+
+}
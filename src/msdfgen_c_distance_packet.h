@@ -0,0 +1,43 @@
+/*
+ * Internal SIMD evaluation of edge distances over packets of neighboring pixels
+ */
+
+#ifndef MSDFGEN_C_DISTANCE_PACKET_H
+#define MSDFGEN_C_DISTANCE_PACKET_H
+
+#include "msdfgen.h"
+
+namespace msdfgen_c {
+
+/* Pixels per packet of the kernels selected for this CPU, or 0 if it has none */
+int distancePacketWidth();
+
+/*
+ * Generates a true distance SDF in single precision, evaluating each edge against
+ * a packet of horizontally adjacent pixels at once. Edges whose bounds are farther
+ * from a packet than the distances already found are skipped. Without overlap
+ * support, the nearest edge of the previous packet is evaluated first; linear and
+ * cubic segments then give exactly the distances of generateSDFFlat<float>, and
+ * quadratic segments differ from it by rounding only. This requires a nonzero
+ * distancePacketWidth(). With overlap support, the distances of the contours are
+ * combined like msdfgen's OverlappingContourCombiner does.
+ * Returns the number of edge distances computed.
+ */
+unsigned long long generateSDFPackets(const msdfgen::BitmapRef<float, 1>& output, const msdfgen::Shape& shape, const msdfgen::SDFTransformation& transformation, bool overlapSupport);
+
+/*
+ * Generate the distances of msdfgen::generateMSDF and generateMTSDF, without error
+ * correction, in single precision over packets of pixels. The edges are visited and
+ * their distances, perpendicular distances past their ends and colors selected like
+ * msdfgen's MultiDistanceSelector and MultiAndTrueDistanceSelector do, and with
+ * overlap support, combined like its OverlappingContourCombiner. The results differ
+ * from msdfgen's by the rounding of single precision. On CPUs without packet kernels
+ * (a distancePacketWidth() of 0), packets of a single pixel are used.
+ * Return the number of edge distances computed.
+ */
+unsigned long long generateMSDFPackets(const msdfgen::BitmapRef<float, 3>& output, const msdfgen::Shape& shape, const msdfgen::SDFTransformation& transformation, bool overlapSupport);
+unsigned long long generateMTSDFPackets(const msdfgen::BitmapRef<float, 4>& output, const msdfgen::Shape& shape, const msdfgen::SDFTransformation& transformation, bool overlapSupport);
+
+}
+
+#endif /* MSDFGEN_C_DISTANCE_PACKET_H */
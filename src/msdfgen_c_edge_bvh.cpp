@@ -0,0 +1,171 @@
+/*
+ * Internal bounding volume hierarchy over the edges of a shape
+ */
+
+#include "msdfgen_c_edge_bvh.h"
+#include "msdfgen_c_distance_finder.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace msdfgen;
+
+namespace msdfgen_c {
+
+#define MSDFGEN_C_BVH_LEAF_EDGES 4
+#define MSDFGEN_C_BVH_MAX_DEPTH 64
+
+static double boxDistanceSquared(const Point2& p, double l, double b, double r, double t) {
+    double dx = std::max(std::max(l - p.x, p.x - r), 0.0);
+    double dy = std::max(std::max(b - p.y, p.y - t), 0.0);
+    return dx * dx + dy * dy;
+}
+
+EdgeBvh::EdgeBvh(const Shape& shape) : margin(0) {
+    Box extent = {DBL_MAX, DBL_MAX, -DBL_MAX, -DBL_MAX};
+    // Edges are numbered in the order msdfgen's ShapeDistanceFinder visits them
+    for (const Contour& contour : shape.contours) {
+        for (size_t i = 0; i < contour.edges.size(); i++) {
+            Edge edge;
+            edge.segment = visitedEdge(contour, i);
+            edge.box.l = DBL_MAX, edge.box.b = DBL_MAX, edge.box.r = -DBL_MAX, edge.box.t = -DBL_MAX;
+            edge.segment->bound(edge.box.l, edge.box.b, edge.box.r, edge.box.t);
+            edge.index = static_cast<int>(edges.size());
+            edges.push_back(edge);
+            extent.l = std::min(extent.l, edge.box.l);
+            extent.b = std::min(extent.b, edge.box.b);
+            extent.r = std::max(extent.r, edge.box.r);
+            extent.t = std::max(extent.t, edge.box.t);
+        }
+    }
+    if (edges.empty()) return;
+
+    // Segment bounds and distances are both subject to rounding; pruning only
+    // happens beyond this slack so that no edge that could win is ever skipped
+    margin = 1e-9 * (1.0 + std::max(extent.r - extent.l, extent.t - extent.b));
+
+    nodes.reserve(2 * edges.size() / MSDFGEN_C_BVH_LEAF_EDGES + 1);
+    build(0, static_cast<int>(edges.size()));
+    edgePositions.resize(edges.size());
+    for (int i = 0; i < static_cast<int>(edges.size()); i++) {
+        edgePositions[edges[i].index] = i;
+    }
+}
+
+int EdgeBvh::build(int first, int count) {
+    int nodeIndex = static_cast<int>(nodes.size());
+    nodes.push_back(Node());
+
+    Box box = {DBL_MAX, DBL_MAX, -DBL_MAX, -DBL_MAX};
+    Box centers = box;
+    for (int i = first; i < first + count; i++) {
+        const Box& edgeBox = edges[i].box;
+        box.l = std::min(box.l, edgeBox.l);
+        box.b = std::min(box.b, edgeBox.b);
+        box.r = std::max(box.r, edgeBox.r);
+        box.t = std::max(box.t, edgeBox.t);
+        double cx = 0.5 * (edgeBox.l + edgeBox.r), cy = 0.5 * (edgeBox.b + edgeBox.t);
+        centers.l = std::min(centers.l, cx);
+        centers.b = std::min(centers.b, cy);
+        centers.r = std::max(centers.r, cx);
+        centers.t = std::max(centers.t, cy);
+    }
+    nodes[nodeIndex].box = box;
+    nodes[nodeIndex].first = first;
+    nodes[nodeIndex].count = count;
+    nodes[nodeIndex].secondChild = -1;
+    if (count <= MSDFGEN_C_BVH_LEAF_EDGES) {
+        return nodeIndex;
+    }
+
+    // Median split along the longer axis of the edge centers
+    bool splitX = centers.r - centers.l >= centers.t - centers.b;
+    int half = count / 2;
+    std::nth_element(edges.begin() + first, edges.begin() + first + half, edges.begin() + first + count, [splitX](const Edge& a, const Edge& b) {
+        return splitX ? a.box.l + a.box.r < b.box.l + b.box.r : a.box.b + a.box.t < b.box.b + b.box.t;
+    });
+    build(first, half);
+    int secondChild = build(first + half, count - half);
+    nodes[nodeIndex].count = 0;
+    nodes[nodeIndex].secondChild = secondChild;
+    return nodeIndex;
+}
+
+SignedDistance EdgeBvh::distance(Point2 origin, int& hint, unsigned long long& evaluations) const {
+    SignedDistance best;
+    int bestIndex = -1;
+    double limit = DBL_MAX;
+    auto consider = [&](const Edge& edge) {
+        double param;
+        SignedDistance distance = edge.segment->signedDistance(origin, param);
+        evaluations++;
+        if (distance < best || (!(best < distance) && edge.index < bestIndex)) {
+            best = distance;
+            bestIndex = edge.index;
+            limit = fabs(best.distance) + margin;
+            limit *= limit;
+        }
+    };
+    if (nodes.empty()) return best;
+
+    int skipped = -1;
+    if (hint >= 0 && hint < static_cast<int>(edges.size())) {
+        consider(edges[edgePositions[hint]]);
+        skipped = hint;
+    }
+
+    int stack[MSDFGEN_C_BVH_MAX_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        int nodeIndex = stack[--stackSize];
+        const Node& node = nodes[nodeIndex];
+        if (boxDistanceSquared(origin, node.box.l, node.box.b, node.box.r, node.box.t) > limit) continue;
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; i++) {
+                const Edge& edge = edges[i];
+                if (edge.index == skipped) continue;
+                if (boxDistanceSquared(origin, edge.box.l, edge.box.b, edge.box.r, edge.box.t) > limit) continue;
+                consider(edge);
+            }
+        } else {
+            // Push the farther child first so that the nearer one is searched first
+            int near = nodeIndex + 1, far = node.secondChild;
+            const Box& nearBox = nodes[near].box;
+            const Box& farBox = nodes[far].box;
+            if (boxDistanceSquared(origin, nearBox.l, nearBox.b, nearBox.r, nearBox.t) > boxDistanceSquared(origin, farBox.l, farBox.b, farBox.r, farBox.t)) {
+                std::swap(near, far);
+            }
+            stack[stackSize++] = far;
+            stack[stackSize++] = near;
+        }
+    }
+    hint = bestIndex;
+    return best;
+}
+
+unsigned long long generateSDFAccelerated(const BitmapRef<float, 1>& output, const Shape& shape, const SDFTransformation& transformation) {
+    EdgeBvh bvh(shape);
+    bool inverseYAxis = shape.getYAxisOrientation() == Y_DOWNWARD;
+    unsigned long long evaluations = 0;
+#ifdef MSDFGEN_USE_OPENMP
+    #pragma omp parallel reduction(+:evaluations)
+#endif
+    {
+        int hint = -1;
+#ifdef MSDFGEN_USE_OPENMP
+        #pragma omp for
+#endif
+        for (int y = 0; y < output.height; y++) {
+            int row = inverseYAxis ? output.height - y - 1 : y;
+            for (int x = 0; x < output.width; x++) {
+                Point2 p = transformation.unproject(Point2(x + .5, y + .5));
+                *output(x, row) = float(transformation.distanceMapping(bvh.distance(p, hint, evaluations).distance));
+            }
+        }
+    }
+    return evaluations;
+}
+
+}
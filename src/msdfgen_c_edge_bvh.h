@@ -0,0 +1,68 @@
+/*
+ * Internal bounding volume hierarchy over the edges of a shape
+ */
+
+#ifndef MSDFGEN_C_EDGE_BVH_H
+#define MSDFGEN_C_EDGE_BVH_H
+
+#include "msdfgen.h"
+
+#include <vector>
+
+namespace msdfgen_c {
+
+/*
+ * Answers true signed distance queries over all edges of a shape, skipping every
+ * subtree whose bounding box is farther away than the best distance found so far.
+ * The result is the minimum SignedDistance over all edges, with ties going to the
+ * edge that msdfgen's ShapeDistanceFinder visits first, each contour's last edge
+ * before its others, which is what its SimpleContourCombiner with a
+ * TrueDistanceSelector computes by visiting every edge.
+ */
+class EdgeBvh {
+
+public:
+    explicit EdgeBvh(const msdfgen::Shape& shape);
+
+    /*
+     * hint is the index of the nearest edge of the previous query, or -1. It is
+     * evaluated first to tighten the search and is updated to the new nearest edge.
+     * evaluations is increased by the number of edge distances computed.
+     */
+    msdfgen::SignedDistance distance(msdfgen::Point2 origin, int& hint, unsigned long long& evaluations) const;
+
+private:
+    struct Box {
+        double l, b, r, t;
+    };
+    struct Edge {
+        const msdfgen::EdgeSegment* segment;
+        Box box;
+        int index;
+    };
+    struct Node {
+        Box box;
+        int first;          /* First edge of a leaf */
+        int count;          /* Edge count of a leaf, 0 for inner nodes */
+        int secondChild;    /* Inner nodes: the first child immediately follows the node */
+    };
+
+    std::vector<Edge> edges;
+    std::vector<int> edgePositions;
+    std::vector<Node> nodes;
+    double margin;
+
+    int build(int first, int count);
+
+};
+
+/*
+ * Generates a true distance SDF without overlap support using an EdgeBvh.
+ * Pixels are sampled and mapped exactly like msdfgen::generateSDF with overlap
+ * support disabled. Returns the number of edge distances computed.
+ */
+unsigned long long generateSDFAccelerated(const msdfgen::BitmapRef<float, 1>& output, const msdfgen::Shape& shape, const msdfgen::SDFTransformation& transformation);
+
+}
+
+#endif /* MSDFGEN_C_EDGE_BVH_H */
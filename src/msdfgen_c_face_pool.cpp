@@ -0,0 +1,104 @@
+/*
+ * Internal pool of FreeType faces sharing one memory-mapped font file
+ */
+
+#include "msdfgen_c_face_pool.h"
+
+#ifdef MSDFGEN_USE_EXTENSIONS
+
+#include FT_MULTIPLE_MASTERS_H
+
+namespace msdfgen_c {
+
+struct FacePool::Entry {
+    FT_Library library;
+    FT_Face face;
+    unsigned generation;    /* Variation coordinates last applied to the face */
+};
+
+FacePool::Lease::Lease(FacePool& pool) : pool(pool), entry(pool.acquire()) { }
+
+FacePool::Lease::~Lease() {
+    if (entry) {
+        pool.release(entry);
+    }
+}
+
+FT_Face FacePool::Lease::face() const {
+    return entry ? entry->face : nullptr;
+}
+
+FacePool::FacePool() : generation(0) { }
+
+FacePool::~FacePool() {
+    for (Entry* entry : entries) {
+        FT_Done_Face(entry->face);
+        FT_Done_FreeType(entry->library);
+        delete entry;
+    }
+}
+
+bool FacePool::open(const char* path) {
+    return mapping.open(path) && mapping.size() > 0;
+}
+
+const unsigned char* FacePool::data() const {
+    return mapping.data();
+}
+
+size_t FacePool::size() const {
+    return mapping.size();
+}
+
+void FacePool::setVariationCoordinates(const FT_Fixed* newCoordinates, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    coordinates.assign(newCoordinates, newCoordinates + count);
+    ++generation;
+}
+
+FacePool::Entry* FacePool::acquire() {
+    Entry* entry = nullptr;
+    std::vector<FT_Fixed> current;
+    unsigned currentGeneration;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!idle.empty()) {
+            entry = idle.back();
+            idle.pop_back();
+        }
+        currentGeneration = generation;
+        if (!entry || entry->generation != currentGeneration) {
+            current = coordinates;
+        }
+    }
+
+    // Faces are created and updated outside the lock, as only this thread holds them
+    if (!entry) {
+        FT_Library library;
+        if (FT_Init_FreeType(&library)) return nullptr;
+        FT_Face face;
+        if (FT_New_Memory_Face(library, mapping.data(), static_cast<FT_Long>(mapping.size()), 0, &face)) {
+            FT_Done_FreeType(library);
+            return nullptr;
+        }
+        entry = new Entry{library, face, 0};
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.push_back(entry);
+    }
+    if (entry->generation != currentGeneration) {
+        if (!current.empty()) {
+            FT_Set_Var_Design_Coordinates(entry->face, static_cast<FT_UInt>(current.size()), current.data());
+        }
+        entry->generation = currentGeneration;
+    }
+    return entry;
+}
+
+void FacePool::release(Entry* entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    idle.push_back(entry);
+}
+
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * Internal pool of FreeType faces sharing one memory-mapped font file
+ */
+
+#ifndef MSDFGEN_C_FACE_POOL_H
+#define MSDFGEN_C_FACE_POOL_H
+
+#ifdef MSDFGEN_USE_EXTENSIONS
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include "msdfgen_c_mapped_file.h"
+
+#include <mutex>
+#include <vector>
+
+namespace msdfgen_c {
+
+/*
+ * FreeType faces over one read-only mapping of a font file, so glyphs can be loaded
+ * on several threads at once. A face is lent to one thread at a time and has its own
+ * FT_Library, as FreeType objects may not be shared between threads without locking.
+ * Faces are created on demand, at most one per concurrently loading thread, and kept
+ * until the pool is destroyed. Variation coordinates set on the pool are applied to
+ * each face the next time it is lent out; setting them must not overlap with leases.
+ */
+class FacePool {
+
+    struct Entry;
+
+public:
+    /* Lends a face of the pool for the lifetime of the lease; face() is null if none could be created */
+    class Lease {
+
+    public:
+        explicit Lease(FacePool& pool);
+        ~Lease();
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        FT_Face face() const;
+
+    private:
+        FacePool& pool;
+        Entry* entry;
+
+    };
+
+    FacePool();
+    ~FacePool();
+    FacePool(const FacePool&) = delete;
+    FacePool& operator=(const FacePool&) = delete;
+
+    /* Maps the font file at the UTF-8 path; the mapping stays until the pool is destroyed */
+    bool open(const char* path);
+
+    const unsigned char* data() const;
+    size_t size() const;
+
+    void setVariationCoordinates(const FT_Fixed* coordinates, size_t count);
+
+private:
+    MappedFile mapping;
+    std::mutex mutex;
+    std::vector<Entry*> entries;
+    std::vector<Entry*> idle;
+    std::vector<FT_Fixed> coordinates;
+    unsigned generation;
+
+    Entry* acquire();
+    void release(Entry* entry);
+
+};
+
+}
+
+#endif
+
+#endif /* MSDFGEN_C_FACE_POOL_H */
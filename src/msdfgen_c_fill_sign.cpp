@@ -0,0 +1,97 @@
+/*
+ * Internal sign resolution of distance fields by scanline fill classification
+ */
+
+#include "msdfgen_c_fill_sign.h"
+
+#include <vector>
+
+using namespace msdfgen;
+
+namespace msdfgen_c {
+
+/* Value of zero distance and whether the inside maps to larger values */
+struct FieldZero {
+    float value;
+    bool insideAbove;
+};
+
+static FieldZero fieldZero(const SDFTransformation& transformation) {
+    FieldZero zero;
+    zero.value = float(transformation.distanceMapping(0.0));
+    zero.insideAbove = transformation.distanceMapping(1.0) > transformation.distanceMapping(0.0);
+    return zero;
+}
+
+static inline void mirror(float* channels, int count, float zero) {
+    for (int i = 0; i < count; i++) {
+        channels[i] = 2.0f * zero - channels[i];
+    }
+}
+
+template <int N>
+void applyFillSign(const BitmapRef<float, N>& sdf, const Shape& shape, const SDFTransformation& transformation, FillRule fillRule) {
+    FieldZero zero = fieldZero(transformation);
+    bool inverseYAxis = shape.getYAxisOrientation() == Y_DOWNWARD;
+    int width = sdf.width, height = sdf.height;
+
+    // Whether each pixel's median agreed with its fill (1), was mirrored (-1) or was exactly at zero (0)
+    std::vector<signed char> matches(static_cast<size_t>(width) * height);
+    bool ambiguous = false;
+#ifdef MSDFGEN_USE_OPENMP
+    #pragma omp parallel reduction(||:ambiguous)
+#endif
+    {
+        Scanline scanline;
+#ifdef MSDFGEN_USE_OPENMP
+        #pragma omp for
+#endif
+        for (int y = 0; y < height; y++) {
+            int row = inverseYAxis ? height - y - 1 : y;
+            shape.scanline(scanline, transformation.unprojectY(y + .5));
+            signed char* match = matches.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; x++) {
+                bool fill = scanline.filled(transformation.unprojectX(x + .5), fillRule);
+                float* msd = sdf(x, row);
+                float sd = N >= 3 ? median(msd[0], msd[1], msd[2]) : msd[0];
+                if (sd == zero.value) {
+                    ambiguous = true;
+                    match[x] = 0;
+                } else if (((sd > zero.value) == zero.insideAbove) == fill) {
+                    match[x] = 1;
+                } else {
+                    mirror(msd, N >= 3 ? 3 : 1, zero.value);
+                    match[x] = -1;
+                }
+                if (N == 4 && msd[3] != zero.value && ((msd[3] > zero.value) == zero.insideAbove) != fill) {
+                    mirror(msd + 3, 1, zero.value);
+                }
+            }
+        }
+    }
+
+    // Pixels exactly at zero cannot tell their side and follow their neighbors, which avoids artifacts where the whole shape is inverted
+    if (N >= 3 && ambiguous) {
+        for (int y = 0; y < height; y++) {
+            int row = inverseYAxis ? height - y - 1 : y;
+            const signed char* match = matches.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; x++) {
+                if (match[x]) continue;
+                int neighborMatch = 0;
+                if (x > 0) neighborMatch += match[x - 1];
+                if (x < width - 1) neighborMatch += match[x + 1];
+                if (y > 0) neighborMatch += match[x - width];
+                if (y < height - 1) neighborMatch += match[x + width];
+                if (neighborMatch < 0) {
+                    mirror(sdf(x, row), 3, zero.value);
+                }
+            }
+        }
+    }
+}
+
+template void applyFillSign(const BitmapRef<float, 1>& sdf, const Shape& shape, const SDFTransformation& transformation, FillRule fillRule);
+template void applyFillSign(const BitmapRef<float, 3>& sdf, const Shape& shape, const SDFTransformation& transformation, FillRule fillRule);
+template void applyFillSign(const BitmapRef<float, 4>& sdf, const Shape& shape, const SDFTransformation& transformation, FillRule fillRule);
+
+}
@@ -0,0 +1,25 @@
+/*
+ * Internal sign resolution of distance fields by scanline fill classification
+ */
+
+#ifndef MSDFGEN_C_FILL_SIGN_H
+#define MSDFGEN_C_FILL_SIGN_H
+
+#include "msdfgen.h"
+
+namespace msdfgen_c {
+
+/*
+ * Gives each pixel of a field the side of the outline that fillRule assigns to its
+ * center, like msdfgen's distanceSignCorrection. The intersections of each pixel row
+ * with the shape are computed once, and pixels on the wrong side of zero distance are
+ * mirrored around it. Multi-channel pixels are classified by their median; pixels
+ * whose median is exactly at zero follow the majority of their four neighbors, and
+ * the fourth channel of an MTSDF is classified on its own.
+ */
+template <int N>
+void applyFillSign(const msdfgen::BitmapRef<float, N>& sdf, const msdfgen::Shape& shape, const msdfgen::SDFTransformation& transformation, msdfgen::FillRule fillRule);
+
+}
+
+#endif /* MSDFGEN_C_FILL_SIGN_H */
@@ -0,0 +1,401 @@
+/*
+ * Internal flattened copy of a shape with distance kernels in float or double
+ *
+ * The kernels follow msdfgen's LinearSegment, QuadraticSegment and CubicSegment
+ * signedDistance and its equation solver operation by operation, so that the
+ * double instantiation reproduces msdfgen and the float instantiation differs
+ * from it only by rounding.
+ */
+
+#include "msdfgen_c_flat_shape.h"
+#include "msdfgen_c_distance_finder.h"
+#include "msdfgen_c_pooled_shape.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+using namespace msdfgen;
+
+namespace msdfgen_c {
+
+/* Newton search of msdfgen's CubicSegment: starting points and steps per start */
+#define MSDFGEN_C_CUBIC_SEARCH_STARTS 4
+#define MSDFGEN_C_CUBIC_SEARCH_STEPS 4
+
+template <typename T>
+struct FlatVector {
+    T x, y;
+};
+
+template <typename T>
+static inline FlatVector<T> operator+(FlatVector<T> a, FlatVector<T> b) {
+    return {a.x + b.x, a.y + b.y};
+}
+
+template <typename T>
+static inline FlatVector<T> operator-(FlatVector<T> a, FlatVector<T> b) {
+    return {a.x - b.x, a.y - b.y};
+}
+
+template <typename T>
+static inline FlatVector<T> operator*(T s, FlatVector<T> v) {
+    return {s * v.x, s * v.y};
+}
+
+template <typename T>
+static inline T dot(FlatVector<T> a, FlatVector<T> b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+template <typename T>
+static inline T cross(FlatVector<T> a, FlatVector<T> b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+template <typename T>
+static inline T length(FlatVector<T> v) {
+    return std::sqrt(v.x * v.x + v.y * v.y);
+}
+
+/* Vector2::normalize(), which maps the zero vector to (0, 1) */
+template <typename T>
+static inline FlatVector<T> normalize(FlatVector<T> v) {
+    T len = length(v);
+    if (len == 0) return {T(0), T(1)};
+    return {v.x / len, v.y / len};
+}
+
+template <typename T>
+static inline T nonZeroSign(T n) {
+    return T(2 * (n > 0) - 1);
+}
+
+template <typename T>
+static inline FlatVector<T> point(const FlatEdge<T>& edge, int i) {
+    return {edge.x[i], edge.y[i]};
+}
+
+template <typename T>
+FlatDistance<T>::FlatDistance() : distance(-std::numeric_limits<T>::max()), dot(0) { }
+
+template <typename T>
+bool FlatDistance<T>::operator<(const FlatDistance& other) const {
+    T a = std::fabs(distance), b = std::fabs(other.distance);
+    return a < b || (a == b && dot < other.dot);
+}
+
+template <typename T>
+static int solveQuadratic(T x[2], T a, T b, T c) {
+    if (a == 0 || std::fabs(b) > SolverLimits<T>::linearRatio * std::fabs(a)) {
+        if (b == 0) {
+            return c == 0 ? -1 : 0;
+        }
+        x[0] = -c / b;
+        return 1;
+    }
+    T dscr = b * b - 4 * a * c;
+    if (dscr > 0) {
+        dscr = std::sqrt(dscr);
+        x[0] = (-b + dscr) / (2 * a);
+        x[1] = (-b - dscr) / (2 * a);
+        return 2;
+    } else if (dscr == 0) {
+        x[0] = -b / (2 * a);
+        return 1;
+    }
+    return 0;
+}
+
+template <typename T>
+static int solveCubicNormed(T x[3], T a, T b, T c) {
+    const T tau = T(6.283185307179586);
+    T a2 = a * a;
+    T q = T(1 / 9.) * (a2 - 3 * b);
+    T r = T(1 / 54.) * (a * (2 * a2 - 9 * b) + 27 * c);
+    T r2 = r * r;
+    T q3 = q * q * q;
+    a *= T(1 / 3.);
+    if (r2 < q3) {
+        T t = r / std::sqrt(q3);
+        t = std::max(T(-1), std::min(T(1), t));
+        t = std::acos(t);
+        q = -2 * std::sqrt(q);
+        x[0] = q * std::cos(T(1 / 3.) * t) - a;
+        x[1] = q * std::cos(T(1 / 3.) * (t + tau)) - a;
+        x[2] = q * std::cos(T(1 / 3.) * (t - tau)) - a;
+        return 3;
+    }
+    T u = (r < 0 ? 1 : -1) * std::pow(std::fabs(r) + std::sqrt(r2 - q3), T(1 / 3.));
+    T v = u == 0 ? 0 : q / u;
+    x[0] = (u + v) - a;
+    if (u == v || std::fabs(u - v) < SolverLimits<T>::doubleRoot * std::fabs(u + v)) {
+        x[1] = T(-.5) * (u + v) - a;
+        return 2;
+    }
+    return 1;
+}
+
+template <typename T>
+static int solveCubic(T x[3], T a, T b, T c, T d) {
+    if (a != 0) {
+        T bn = b / a;
+        if (std::fabs(bn) < SolverLimits<T>::quadraticRatio) {
+            return solveCubicNormed(x, bn, c / a, d / a);
+        }
+    }
+    return solveQuadratic(x, b, c, d);
+}
+
+template <typename T>
+static FlatDistance<T> linearDistance(const FlatEdge<T>& edge, FlatVector<T> origin, T& param) {
+    FlatVector<T> p0 = point(edge, 0), p1 = point(edge, 1);
+    FlatVector<T> aq = origin - p0;
+    FlatVector<T> ab = p1 - p0;
+    FlatVector<T> direction = ab.x == 0 && ab.y == 0 ? FlatVector<T>{edge.directionX, edge.directionY} : ab;
+    param = dot(aq, direction) / dot(ab, ab);
+    FlatVector<T> eq = (param > T(.5) ? p1 : p0) - origin;
+    T endpointDistance = length(eq);
+    if (param > 0 && param < 1) {
+        // Vector2::getOrthonormal(false), which maps the zero vector to (0, -1)
+        T len = length(ab);
+        FlatVector<T> orthonormal = len == 0 ? FlatVector<T>{T(0), T(-1)} : FlatVector<T>{ab.y / len, -ab.x / len};
+        T orthoDistance = dot(orthonormal, aq);
+        if (std::fabs(orthoDistance) < endpointDistance) {
+            return FlatDistance<T>(orthoDistance, 0);
+        }
+    }
+    return FlatDistance<T>(nonZeroSign(cross(aq, direction)) * endpointDistance, std::fabs(dot(normalize(direction), normalize(eq))));
+}
+
+template <typename T>
+static FlatDistance<T> quadraticDistance(const FlatEdge<T>& edge, FlatVector<T> origin, T& param) {
+    FlatVector<T> p0 = point(edge, 0), p1 = point(edge, 1), p2 = point(edge, 2);
+    FlatVector<T> qa = p0 - origin;
+    FlatVector<T> ab = p1 - p0;
+    FlatVector<T> br = p2 - p1 - ab;
+    T a = dot(br, br);
+    T b = 3 * dot(ab, br);
+    T c = 2 * dot(ab, ab) + dot(qa, br);
+    T d = dot(qa, ab);
+    T t[3];
+    int solutions = solveCubic(t, a, b, c, d);
+
+    // QuadraticSegment::direction at both ends, falling back to the chord where a control point coincides with an end
+    FlatVector<T> startDir = ab, endDir = p2 - p1;
+    if (startDir.x == 0 && startDir.y == 0) startDir = p2 - p0;
+    if (endDir.x == 0 && endDir.y == 0) endDir = p2 - p0;
+
+    FlatVector<T> epDir = startDir;
+    T minDistance = nonZeroSign(cross(epDir, qa)) * length(qa);
+    param = -dot(qa, epDir) / dot(epDir, epDir);
+    FlatVector<T> bq = p2 - origin;
+    {
+        T distance = length(bq);
+        if (distance < std::fabs(minDistance)) {
+            epDir = endDir;
+            minDistance = nonZeroSign(cross(epDir, bq)) * distance;
+            param = dot(origin - p1, epDir) / dot(epDir, epDir);
+        }
+    }
+    for (int i = 0; i < solutions; i++) {
+        if (t[i] > 0 && t[i] < 1) {
+            FlatVector<T> qe = qa + (2 * t[i]) * ab + (t[i] * t[i]) * br;
+            T distance = length(qe);
+            if (distance <= std::fabs(minDistance)) {
+                minDistance = nonZeroSign(cross(ab + t[i] * br, qe)) * distance;
+                param = t[i];
+            }
+        }
+    }
+
+    if (param >= 0 && param <= 1) {
+        return FlatDistance<T>(minDistance, 0);
+    }
+    if (param < T(.5)) {
+        return FlatDistance<T>(minDistance, std::fabs(dot(normalize(startDir), normalize(qa))));
+    }
+    return FlatDistance<T>(minDistance, std::fabs(dot(normalize(endDir), normalize(bq))));
+}
+
+template <typename T>
+static FlatDistance<T> cubicDistance(const FlatEdge<T>& edge, FlatVector<T> origin, T& param) {
+    FlatVector<T> p0 = point(edge, 0), p1 = point(edge, 1), p2 = point(edge, 2), p3 = point(edge, 3);
+    FlatVector<T> qa = p0 - origin;
+    FlatVector<T> ab = p1 - p0;
+    FlatVector<T> br = p2 - p1 - ab;
+    FlatVector<T> as = (p3 - p2) - (p2 - p1) - br;
+
+    // CubicSegment::direction at both ends, skipping a control point that coincides with the end
+    FlatVector<T> startDir = ab, endDir = p3 - p2;
+    if (startDir.x == 0 && startDir.y == 0) startDir = p2 - p0;
+    if (endDir.x == 0 && endDir.y == 0) endDir = p3 - p1;
+
+    FlatVector<T> epDir = startDir;
+    T minDistance = nonZeroSign(cross(epDir, qa)) * length(qa);
+    param = -dot(qa, epDir) / dot(epDir, epDir);
+    FlatVector<T> bq = p3 - origin;
+    {
+        T distance = length(bq);
+        if (distance < std::fabs(minDistance)) {
+            epDir = endDir;
+            minDistance = nonZeroSign(cross(epDir, bq)) * distance;
+            param = dot(epDir - bq, epDir) / dot(epDir, epDir);
+        }
+    }
+    for (int i = 0; i <= MSDFGEN_C_CUBIC_SEARCH_STARTS; i++) {
+        T t = T(1. / MSDFGEN_C_CUBIC_SEARCH_STARTS * i);
+        FlatVector<T> qe = qa + (3 * t) * ab + (3 * t * t) * br + (t * t * t) * as;
+        FlatVector<T> d1 = T(3) * ab + (6 * t) * br + (3 * t * t) * as;
+        FlatVector<T> d2 = T(6) * br + (6 * t) * as;
+        T improvedT = t - dot(qe, d1) / (dot(d1, d1) + dot(qe, d2));
+        if (improvedT > 0 && improvedT < 1) {
+            int remainingSteps = MSDFGEN_C_CUBIC_SEARCH_STEPS;
+            do {
+                t = improvedT;
+                qe = qa + (3 * t) * ab + (3 * t * t) * br + (t * t * t) * as;
+                d1 = T(3) * ab + (6 * t) * br + (3 * t * t) * as;
+                if (!--remainingSteps) break;
+                d2 = T(6) * br + (6 * t) * as;
+                improvedT = t - dot(qe, d1) / (dot(d1, d1) + dot(qe, d2));
+            } while (improvedT > 0 && improvedT < 1);
+            T distance = length(qe);
+            if (distance < std::fabs(minDistance)) {
+                minDistance = nonZeroSign(cross(d1, qe)) * distance;
+                param = t;
+            }
+        }
+    }
+
+    if (param >= 0 && param <= 1) {
+        return FlatDistance<T>(minDistance, 0);
+    }
+    if (param < T(.5)) {
+        return FlatDistance<T>(minDistance, std::fabs(dot(normalize(startDir), normalize(qa))));
+    }
+    return FlatDistance<T>(minDistance, std::fabs(dot(normalize(endDir), normalize(bq))));
+}
+
+template <typename T>
+FlatDistance<T> edgeDistance(const FlatEdge<T>& edge, T x, T y, T& param) {
+    FlatVector<T> origin = {x, y};
+    switch (edge.pointCount) {
+        case 2: return linearDistance(edge, origin, param);
+        case 3: return quadraticDistance(edge, origin, param);
+        default: return cubicDistance(edge, origin, param);
+    }
+}
+
+template <typename T>
+FlatDistance<T> edgeDistance(const FlatEdge<T>& edge, T x, T y) {
+    T param;
+    return edgeDistance(edge, x, y, param);
+}
+
+template <typename T>
+FlatShape<T>::FlatShape(const Shape& shape) {
+    double l = DBL_MAX, b = DBL_MAX, r = -DBL_MAX, t = -DBL_MAX;
+    size_t edgeCount = 0;
+    for (const Contour& contour : shape.contours) {
+        for (const EdgeHolder& edge : contour.edges) {
+            int pointCount;
+            const Point2* points = segmentPoints(edge, pointCount);
+            for (int i = 0; i < pointCount; i++) {
+                l = std::min(l, points[i].x), b = std::min(b, points[i].y);
+                r = std::max(r, points[i].x), t = std::max(t, points[i].y);
+            }
+            edgeCount++;
+        }
+    }
+    if (edgeCount) {
+        center = Vector2(.5 * (l + r), .5 * (b + t));
+    }
+
+    edges.reserve(edgeCount);
+    for (const Contour& contour : shape.contours) {
+        for (size_t i = 0; i < contour.edges.size(); i++) {
+            const EdgeSegment* segment = visitedEdge(contour, i);
+            int pointCount;
+            const Point2* points = segmentPoints(segment, pointCount);
+            if (!points) continue;
+            FlatEdge<T> edge;
+            edge.pointCount = pointCount;
+            edge.color = segment->color;
+            for (int j = 0; j < pointCount; j++) {
+                toLocal(points[j], edge.x[j], edge.y[j]);
+            }
+            Vector2 direction = pointCount == 2 ? (points[1] - points[0]).normalize(true) : Vector2();
+            edge.directionX = T(direction.x), edge.directionY = T(direction.y);
+            edges.push_back(edge);
+        }
+        if (edges.size() > (contourEnds.empty() ? 0 : size_t(contourEnds.back()))) {
+            contourEnds.push_back(static_cast<int>(edges.size()));
+            windings.push_back(contour.winding());
+        }
+    }
+}
+
+/* Where an edge was last evaluated and how far away it was */
+template <typename T>
+struct EdgeCache {
+    T x = 0, y = 0;
+    T absDistance = 0;
+};
+
+template <typename T>
+unsigned long long generateSDFFlat(const BitmapRef<float, 1>& output, const Shape& shape, const SDFTransformation& transformation) {
+    FlatShape<T> flat(shape);
+    const int edgeCount = static_cast<int>(flat.edges.size());
+    bool inverseYAxis = shape.getYAxisOrientation() == Y_DOWNWARD;
+    unsigned long long evaluations = 0;
+#ifdef MSDFGEN_USE_OPENMP
+    #pragma omp parallel reduction(+:evaluations)
+#endif
+    {
+        std::vector<EdgeCache<T>> caches(edgeCount);
+        bool rightToLeft = false;
+#ifdef MSDFGEN_USE_OPENMP
+        #pragma omp for
+#endif
+        for (int y = 0; y < output.height; y++) {
+            int row = inverseYAxis ? output.height - y - 1 : y;
+            for (int col = 0; col < output.width; col++) {
+                int x = rightToLeft ? output.width - col - 1 : col;
+                T px, py;
+                flat.toLocal(transformation.unproject(Point2(x + .5, y + .5)), px, py);
+                FlatDistance<T> best;
+                for (int i = 0; i < edgeCount; i++) {
+                    EdgeCache<T>& cache = caches[i];
+                    T dx = px - cache.x, dy = py - cache.y;
+                    T delta = T(MSDFGEN_C_DISTANCE_DELTA_FACTOR) * std::sqrt(dx * dx + dy * dy);
+                    if (cache.absDistance - delta <= std::fabs(best.distance)) {
+                        FlatDistance<T> distance = edgeDistance(flat.edges[i], px, py);
+                        evaluations++;
+                        if (distance < best) {
+                            best = distance;
+                        }
+                        cache.x = px, cache.y = py;
+                        cache.absDistance = std::fabs(distance.distance);
+                    }
+                }
+                *output(x, row) = float(transformation.distanceMapping(double(best.distance)));
+            }
+            rightToLeft = !rightToLeft;
+        }
+    }
+    return evaluations;
+}
+
+template struct FlatDistance<float>;
+template struct FlatDistance<double>;
+template FlatDistance<float> edgeDistance(const FlatEdge<float>& edge, float x, float y);
+template FlatDistance<double> edgeDistance(const FlatEdge<double>& edge, double x, double y);
+template FlatDistance<float> edgeDistance(const FlatEdge<float>& edge, float x, float y, float& param);
+template FlatDistance<double> edgeDistance(const FlatEdge<double>& edge, double x, double y, double& param);
+template class FlatShape<float>;
+template class FlatShape<double>;
+template unsigned long long generateSDFFlat<float>(const BitmapRef<float, 1>& output, const Shape& shape, const SDFTransformation& transformation);
+template unsigned long long generateSDFFlat<double>(const BitmapRef<float, 1>& output, const Shape& shape, const SDFTransformation& transformation);
+
+}
@@ -0,0 +1,114 @@
+/*
+ * Internal flattened copy of a shape with distance kernels in float or double
+ */
+
+#ifndef MSDFGEN_C_FLAT_SHAPE_H
+#define MSDFGEN_C_FLAT_SHAPE_H
+
+#include "msdfgen.h"
+
+#include <vector>
+
+namespace msdfgen_c {
+
+/*
+ * Tolerances of the equation solver. The double values are msdfgen's; the float
+ * values are scaled by the same powers of the single precision epsilon.
+ */
+template <typename T>
+struct SolverLimits;
+
+template <>
+struct SolverLimits<double> {
+    static constexpr double linearRatio = 1e12;     /* |b|/|a| beyond which a quadratic is solved as linear */
+    static constexpr double quadraticRatio = 1e6;   /* |b|/|a| beyond which a cubic is solved as quadratic */
+    static constexpr double doubleRoot = 1e-12;     /* Relative difference below which two cubic roots coincide */
+};
+
+template <>
+struct SolverLimits<float> {
+    static constexpr float linearRatio = 1e5f;
+    static constexpr float quadraticRatio = 1e3f;
+    static constexpr float doubleRoot = 1e-5f;
+};
+
+/* Signed distance to an edge, ordered like msdfgen::SignedDistance */
+template <typename T>
+struct FlatDistance {
+    T distance;
+    T dot;
+
+    FlatDistance();
+    FlatDistance(T distance, T dot) : distance(distance), dot(dot) { }
+
+    bool operator<(const FlatDistance& other) const;
+};
+
+/* Control points of one edge segment; pointCount is 2, 3 or 4 for linear, quadratic and cubic segments */
+template <typename T>
+struct FlatEdge {
+    T x[4];
+    T y[4];
+    int pointCount;
+    int color;      /* The segment's msdfgen::EdgeColor */
+    T directionX;   /* Unit direction of a linear segment, used where its points coincide in T */
+    T directionY;
+};
+
+/* Signed distance from (x, y) to the edge, computed in T by the same steps as the segment's signedDistance */
+template <typename T>
+FlatDistance<T> edgeDistance(const FlatEdge<T>& edge, T x, T y);
+
+/* The same, also storing the segment parameter of the nearest point like signedDistance does */
+template <typename T>
+FlatDistance<T> edgeDistance(const FlatEdge<T>& edge, T x, T y, T& param);
+
+/*
+ * The edges of a shape in contour order, stored as plain arrays of T. Points are
+ * taken relative to the center of the shape's bounds before they are converted,
+ * which keeps the magnitudes, and so the rounding error of single precision, down
+ * to the size of the shape rather than its distance from the origin.
+ */
+template <typename T>
+class FlatShape {
+
+public:
+    explicit FlatShape(const msdfgen::Shape& shape);
+
+    std::vector<FlatEdge<T>> edges;
+    std::vector<int> contourEnds;   /* One past the last edge of each contour that has edges */
+    std::vector<int> windings;      /* Contour::winding() of the same contours */
+
+    /* Converts a point in shape coordinates to the local frame of the edges */
+    void toLocal(msdfgen::Point2 p, T& x, T& y) const {
+        x = localX(p.x);
+        y = localY(p.y);
+    }
+
+    T localX(double x) const {
+        return T(x - center.x);
+    }
+
+    T localY(double y) const {
+        return T(y - center.y);
+    }
+
+private:
+    msdfgen::Vector2 center;
+
+};
+
+/*
+ * Generates a true distance SDF without overlap support, evaluating distances in T.
+ * Pixels are sampled, mapped and visited exactly like msdfgen::generateSDF with
+ * overlap support disabled, including its per-edge cache that skips edges which
+ * cannot have come closer since they were last evaluated. With T = double the
+ * result agrees with msdfgen's up to the rounding of the recentered coordinates.
+ * Returns the number of edge distances computed.
+ */
+template <typename T>
+unsigned long long generateSDFFlat(const msdfgen::BitmapRef<float, 1>& output, const msdfgen::Shape& shape, const msdfgen::SDFTransformation& transformation);
+
+}
+
+#endif /* MSDFGEN_C_FLAT_SHAPE_H */
@@ -0,0 +1,370 @@
+/*
+ * Internal FreeType library and font handles of the C API
+ */
+
+#include "msdfgen_c_font.h"
+
+#ifdef MSDFGEN_USE_EXTENSIONS
+
+#include FT_OUTLINE_H
+#include FT_MULTIPLE_MASTERS_H
+#include FT_ADVANCES_H
+#include FT_TRUETYPE_TABLES_H
+#include FT_TRUETYPE_TAGS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <unordered_set>
+
+using namespace msdfgen;
+
+namespace msdfgen_c {
+
+Freetype* createFreetype() {
+    Freetype* freetype = new Freetype();
+    if (FT_Init_FreeType(&freetype->library)) {
+        delete freetype;
+        return nullptr;
+    }
+    return freetype;
+}
+
+void destroyFreetype(Freetype* freetype) {
+    FT_Done_FreeType(freetype->library);
+    delete freetype;
+}
+
+static Font* adoptFace(FT_Face face) {
+    FontHandle* handle = adoptFreetypeFont(face);
+    if (!handle) {
+        FT_Done_Face(face);
+        return nullptr;
+    }
+    Font* font = new Font();
+    font->face = face;
+    font->handle = handle;
+    font->facePool = nullptr;
+    font->axesLoaded = false;
+    return font;
+}
+
+Font* openFont(Freetype& freetype, const char* filename) {
+    FT_Face face;
+    if (FT_New_Face(freetype.library, filename, 0, &face)) return nullptr;
+    return adoptFace(face);
+}
+
+Font* openFontData(Freetype& freetype, const unsigned char* data, int length) {
+    FT_Face face;
+    if (FT_New_Memory_Face(freetype.library, data, static_cast<FT_Long>(length), 0, &face)) return nullptr;
+    return adoptFace(face);
+}
+
+/* The face used for metrics, kerning and variation axes reads the same mapping as the pool */
+Font* openConcurrentFont(Freetype& freetype, const char* filename) {
+    FacePool* pool = new FacePool();
+    FT_Face face;
+    if (!pool->open(filename) || FT_New_Memory_Face(freetype.library, pool->data(), static_cast<FT_Long>(pool->size()), 0, &face)) {
+        delete pool;
+        return nullptr;
+    }
+    Font* font = adoptFace(face);
+    if (!font) {
+        delete pool;
+        return nullptr;
+    }
+    font->facePool = pool;
+    return font;
+}
+
+void closeFont(Font* font) {
+    destroyFont(font->handle);
+    FT_Done_Face(font->face);
+    delete font->facePool;
+    delete font;
+}
+
+unsigned fontGlyphIndex(Font& font, unsigned unicode) {
+    if (font.facePool) {
+        FacePool::Lease lease(*font.facePool);
+        return lease.face() ? FT_Get_Char_Index(lease.face(), unicode) : 0;
+    }
+    return FT_Get_Char_Index(font.face, unicode);
+}
+
+/* Same scale factors as msdfgen's font import */
+static double coordinateScale(FT_Face face, FontCoordinateScaling scaling) {
+    switch (scaling) {
+        case FONT_SCALING_NONE: return 1.0;
+        case FONT_SCALING_EM_NORMALIZED: return 1.0 / (face->units_per_EM ? face->units_per_EM : 1);
+        case FONT_SCALING_LEGACY: return 1.0 / 64.0;
+    }
+    return 1.0;
+}
+
+struct OutlineContext {
+    PooledShape* shape;
+    Contour* contour;
+    Point2 position;
+    double scale;
+};
+
+static Point2 outlinePoint(const FT_Vector& vector, double scale) {
+    return Point2(scale * vector.x, scale * vector.y);
+}
+
+// The decomposition callbacks mirror msdfgen's readFreetypeOutline, including its handling of degenerate edges
+
+static int outlineMoveTo(const FT_Vector* to, void* user) {
+    OutlineContext* context = static_cast<OutlineContext*>(user);
+    if (!(context->contour && context->contour->edges.empty())) {
+        context->contour = &context->shape->addRecycledContour();
+    }
+    context->position = outlinePoint(*to, context->scale);
+    return 0;
+}
+
+static int outlineLineTo(const FT_Vector* to, void* user) {
+    OutlineContext* context = static_cast<OutlineContext*>(user);
+    Point2 endpoint = outlinePoint(*to, context->scale);
+    if (endpoint != context->position) {
+        context->shape->addLinear(*context->contour, context->position, endpoint);
+        context->position = endpoint;
+    }
+    return 0;
+}
+
+static int outlineConicTo(const FT_Vector* control, const FT_Vector* to, void* user) {
+    OutlineContext* context = static_cast<OutlineContext*>(user);
+    Point2 endpoint = outlinePoint(*to, context->scale);
+    if (endpoint != context->position) {
+        context->shape->addQuadratic(*context->contour, context->position, outlinePoint(*control, context->scale), endpoint);
+        context->position = endpoint;
+    }
+    return 0;
+}
+
+static int outlineCubicTo(const FT_Vector* control1, const FT_Vector* control2, const FT_Vector* to, void* user) {
+    OutlineContext* context = static_cast<OutlineContext*>(user);
+    Point2 endpoint = outlinePoint(*to, context->scale);
+    Point2 point1 = outlinePoint(*control1, context->scale);
+    Point2 point2 = outlinePoint(*control2, context->scale);
+    if (endpoint != context->position || crossProduct(point1 - endpoint, point2 - endpoint)) {
+        context->shape->addCubic(*context->contour, context->position, point1, point2, endpoint);
+        context->position = endpoint;
+    }
+    return 0;
+}
+
+static bool decodeGlyph(PooledShape& shape, FT_Face face, unsigned glyphIndex, FontCoordinateScaling scaling, double& advance) {
+    if (FT_Load_Glyph(face, glyphIndex, FT_LOAD_NO_SCALE)) return false;
+    double scale = coordinateScale(face, scaling);
+    advance = scale * face->glyph->advance.x;
+
+    shape.reset();
+    shape.setYAxisOrientation(Y_UPWARD);
+    OutlineContext context = {&shape, nullptr, Point2(), scale};
+    FT_Outline_Funcs functions;
+    functions.move_to = &outlineMoveTo;
+    functions.line_to = &outlineLineTo;
+    functions.conic_to = &outlineConicTo;
+    functions.cubic_to = &outlineCubicTo;
+    functions.shift = 0;
+    functions.delta = 0;
+    FT_Error error = FT_Outline_Decompose(&face->glyph->outline, &functions, &context);
+    if (!shape.contours.empty() && shape.contours.back().edges.empty()) {
+        shape.recycleLastContour();
+    }
+    return !error;
+}
+
+bool loadPooledGlyph(PooledShape& shape, Font& font, unsigned glyphIndex, FontCoordinateScaling scaling, double* advance) {
+    double glyphAdvance = 0;
+    if (font.facePool) {
+        {
+            std::lock_guard<std::mutex> lock(font.glyphCacheMutex);
+            if (font.glyphCache.load(shape, glyphIndex, scaling, advance)) return true;
+        }
+        FacePool::Lease lease(*font.facePool);
+        if (!lease.face() || !decodeGlyph(shape, lease.face(), glyphIndex, scaling, glyphAdvance)) return false;
+        std::lock_guard<std::mutex> lock(font.glyphCacheMutex);
+        font.glyphCache.store(shape, glyphIndex, scaling, glyphAdvance);
+    } else {
+        if (font.glyphCache.load(shape, glyphIndex, scaling, advance)) return true;
+        if (!decodeGlyph(shape, font.face, glyphIndex, scaling, glyphAdvance)) return false;
+        font.glyphCache.store(shape, glyphIndex, scaling, glyphAdvance);
+    }
+    if (advance) {
+        *advance = glyphAdvance;
+    }
+    return true;
+}
+
+bool getGlyphAdvances(Font& font, const unsigned* glyphIndices, int glyphCount, FontCoordinateScaling scaling, double* advances) {
+    double scale = coordinateScale(font.face, scaling);
+    for (int i = 0; i < glyphCount; i++) {
+        FT_Fixed advance;
+        if (FT_Get_Advance(font.face, glyphIndices[i], FT_LOAD_NO_SCALE, &advance)) return false;
+        advances[i] = scale * advance;
+    }
+    return true;
+}
+
+static unsigned readUShort(const FT_Byte* p) {
+    return static_cast<unsigned>(p[0]) << 8 | p[1];
+}
+
+/*
+ * Sums the kerning of every pair of selected glyphs over the subtables of a 'kern'
+ * table the way FreeType's FT_Get_Kerning does: only the first 32 subtables are
+ * read, those whose low coverage bits mark them horizontal and not minimum values
+ * are used whatever their cross-stream and reserved bits, a table's value overrides
+ * the sum of the previous ones if its override bit is set and adds to it otherwise,
+ * and the first entry of a pair within a subtable wins. Unlike FreeType, subtables
+ * of formats other than 0 are skipped rather than read as pair lists. Pairs are
+ * keyed left << 32 | right.
+ */
+static void sumKernTable(const std::vector<FT_Byte>& table, const std::vector<bool>& selected, std::map<uint64_t, int>& values) {
+    const FT_Byte* p = table.data();
+    const FT_Byte* limit = p + table.size();
+    if (table.size() < 4) return;
+    unsigned subtableCount = std::min(readUShort(p + 2), 32u);
+    p += 4;
+    std::unordered_set<uint64_t> seen;
+    for (unsigned i = 0; i < subtableCount && p + 6 <= limit; i++) {
+        const FT_Byte* base = p;
+        unsigned length = readUShort(base + 2);
+        unsigned coverage = readUShort(base + 4);
+        if (length <= 6 + 8) break;
+        const FT_Byte* next = std::min(base + length, limit);
+        p = next;
+        if ((coverage & 3u) != 0x0001 || coverage >> 8 != 0 || base + 14 > next) continue;
+
+        const FT_Byte* pair = base + 14;
+        unsigned pairCount = std::min<unsigned>(readUShort(base + 6), static_cast<unsigned>((next - pair) / 6));
+        bool override = (coverage & 8u) != 0;
+        seen.clear();
+        for (unsigned j = 0; j < pairCount; j++, pair += 6) {
+            unsigned left = readUShort(pair), right = readUShort(pair + 2);
+            if (left >= selected.size() || right >= selected.size() || !selected[left] || !selected[right]) continue;
+            uint64_t key = static_cast<uint64_t>(left) << 32 | right;
+            if (!seen.insert(key).second) continue;
+            int value = static_cast<int16_t>(readUShort(pair + 4));
+            if (override) {
+                values[key] = value;
+            } else {
+                values[key] += value;
+            }
+        }
+    }
+}
+
+bool getKerningPairs(Font& font, const unsigned* glyphIndices, int glyphCount, FontCoordinateScaling scaling, std::vector<MsdfgenKerningPair>& pairs) {
+    pairs.clear();
+    FT_Face face = font.face;
+    if (!FT_HAS_KERNING(face)) return true;
+    double scale = coordinateScale(face, scaling);
+
+    std::map<uint64_t, int> values;
+    FT_ULong tableLength = 0;
+    if (FT_IS_SFNT(face) && !FT_Load_Sfnt_Table(face, TTAG_kern, 0, nullptr, &tableLength)) {
+        std::vector<FT_Byte> table(tableLength);
+        if (FT_Load_Sfnt_Table(face, TTAG_kern, 0, table.data(), &tableLength)) return false;
+        std::vector<bool> selected(face->num_glyphs > 0 ? face->num_glyphs : 0);
+        for (int i = 0; i < glyphCount; i++) {
+            if (glyphIndices[i] < selected.size()) {
+                selected[glyphIndices[i]] = true;
+            }
+        }
+        sumKernTable(table, selected, values);
+    } else {
+        // Kerning from other sources, such as AFM files of Type 1 fonts, can only be queried pair by pair
+        std::vector<unsigned> glyphs(glyphIndices, glyphIndices + glyphCount);
+        std::sort(glyphs.begin(), glyphs.end());
+        glyphs.erase(std::unique(glyphs.begin(), glyphs.end()), glyphs.end());
+        for (unsigned left : glyphs) {
+            for (unsigned right : glyphs) {
+                FT_Vector kerning;
+                if (FT_Get_Kerning(face, left, right, FT_KERNING_UNSCALED, &kerning)) return false;
+                values[static_cast<uint64_t>(left) << 32 | right] = static_cast<int>(kerning.x);
+            }
+        }
+    }
+
+    for (const auto& value : values) {
+        if (!value.second) continue;
+        MsdfgenKerningPair pair;
+        pair.glyphIndex0 = static_cast<unsigned>(value.first >> 32);
+        pair.glyphIndex1 = static_cast<unsigned>(value.first & 0xffffffffu);
+        pair.kerning = scale * value.second;
+        pairs.push_back(pair);
+    }
+    return true;
+}
+
+/* Reads the axes from FreeType on first use; they do not change while the font is open */
+const std::vector<MsdfgenFontVariationAxis>* fontVariationAxes(Freetype& freetype, Font& font) {
+    if (!(font.face->face_flags & FT_FACE_FLAG_MULTIPLE_MASTERS)) return nullptr;
+    if (font.axesLoaded) return &font.axes;
+    FT_MM_Var* master = nullptr;
+    if (FT_Get_MM_Var(font.face, &master)) return nullptr;
+
+    // Axis names are kept with the font, as the ones in master are freed below
+    font.axisNames.assign(master->num_axis, std::string());
+    font.axes.resize(master->num_axis);
+    for (FT_UInt i = 0; i < master->num_axis; i++) {
+        font.axisNames[i] = master->axis[i].name;
+        MsdfgenFontVariationAxis& axis = font.axes[i];
+        axis.name = font.axisNames[i].c_str();
+        axis.minValue = master->axis[i].minimum / 65536.0;
+        axis.maxValue = master->axis[i].maximum / 65536.0;
+        axis.defaultValue = master->axis[i].def / 65536.0;
+    }
+    FT_Done_MM_Var(freetype.library, master);
+    font.axesLoaded = true;
+    return &font.axes;
+}
+
+bool getFontVariationCoordinates(Freetype& freetype, Font& font, std::vector<double>& coordinates) {
+    const std::vector<MsdfgenFontVariationAxis>* axes = fontVariationAxes(freetype, font);
+    if (!axes || axes->empty()) return false;
+    std::vector<FT_Fixed> fixed(axes->size());
+    if (FT_Get_Var_Design_Coordinates(font.face, static_cast<FT_UInt>(fixed.size()), fixed.data())) return false;
+    coordinates.resize(fixed.size());
+    for (size_t i = 0; i < fixed.size(); i++) {
+        coordinates[i] = fixed[i] / 65536.0;
+    }
+    return true;
+}
+
+bool setFontVariationCoordinates(Freetype& freetype, Font& font, const double* coordinates) {
+    const std::vector<MsdfgenFontVariationAxis>* axes = fontVariationAxes(freetype, font);
+    if (!axes || axes->empty()) return false;
+    std::vector<FT_Fixed> fixed(axes->size());
+    for (size_t i = 0; i < fixed.size(); i++) {
+        fixed[i] = static_cast<FT_Fixed>(65536.0 * coordinates[i]);
+    }
+    bool success = !FT_Set_Var_Design_Coordinates(font.face, static_cast<FT_UInt>(fixed.size()), fixed.data());
+    if (font.facePool) {
+        font.facePool->setVariationCoordinates(fixed.data(), fixed.size());
+    }
+    font.glyphCache.clear();
+    return success;
+}
+
+bool setFontVariationAxis(Freetype& freetype, Font& font, const char* name, double coordinate) {
+    std::vector<double> coordinates;
+    if (!getFontVariationCoordinates(freetype, font, coordinates)) return false;
+    for (size_t i = 0; i < coordinates.size(); i++) {
+        if (!strcmp(name, font.axes[i].name)) {
+            coordinates[i] = coordinate;
+            return setFontVariationCoordinates(freetype, font, coordinates.data());
+        }
+    }
+    return false;
+}
+}
+
+#endif
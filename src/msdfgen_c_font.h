@@ -0,0 +1,92 @@
+/*
+ * Internal FreeType library and font handles of the C API
+ */
+
+#ifndef MSDFGEN_C_FONT_H
+#define MSDFGEN_C_FONT_H
+
+#ifdef MSDFGEN_USE_EXTENSIONS
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include "msdfgen.h"
+#include "msdfgen-ext.h"
+#include "msdfgen_c_api.h"
+#include "msdfgen_c_face_pool.h"
+#include "msdfgen_c_glyph_cache.h"
+#include "msdfgen_c_pooled_shape.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace msdfgen_c {
+
+/* FreeType library behind an MsdfgenFreetype handle */
+struct Freetype {
+    FT_Library library;
+};
+
+/*
+ * Font behind an MsdfgenFont handle. The face is owned here and lent to msdfgen
+ * through adoptFreetypeFont, so msdfgen's font functions and the outline reader
+ * below work on the same face. The glyph cache holds outlines for the current
+ * variation coordinates and is cleared whenever they are set. Variation axes are
+ * read once and kept here, with axes[i].name pointing into axisNames[i].
+ * A concurrent font also has a face pool over the mapped file the face reads from;
+ * glyphs are then loaded from pooled faces and the glyph cache is locked.
+ */
+struct Font {
+    FT_Face face;
+    msdfgen::FontHandle* handle;
+    FacePool* facePool;
+    std::mutex glyphCacheMutex;
+    bool axesLoaded;
+    std::vector<std::string> axisNames;
+    std::vector<MsdfgenFontVariationAxis> axes;
+    GlyphCache glyphCache;
+};
+
+Freetype* createFreetype();
+void destroyFreetype(Freetype* freetype);
+
+/* Return null on failure; data must stay valid until the font is closed */
+Font* openFont(Freetype& freetype, const char* filename);
+Font* openFontData(Freetype& freetype, const unsigned char* data, int length);
+/* Font whose glyphs may be loaded from several threads at once */
+Font* openConcurrentFont(Freetype& freetype, const char* filename);
+void closeFont(Font* font);
+
+/* Glyph index of a character; safe to call concurrently with glyph loading if the font is concurrent */
+unsigned fontGlyphIndex(Font& font, unsigned unicode);
+
+/*
+ * Equivalent of msdfgen::loadGlyph that builds the outline in the shape's recycled
+ * storage, served from the font's glyph cache when it is enabled. May be called
+ * from several threads at once if the font is concurrent.
+ */
+bool loadPooledGlyph(PooledShape& shape, Font& font, unsigned glyphIndex, msdfgen::FontCoordinateScaling scaling, double* advance);
+
+/* Unhinted advances of glyphCount glyphs, as msdfgen::loadGlyph reports them */
+bool getGlyphAdvances(Font& font, const unsigned* glyphIndices, int glyphCount, msdfgen::FontCoordinateScaling scaling, double* advances);
+
+/*
+ * All non-zero kerning pairs among the given glyphs, sorted by left then right glyph,
+ * with the values FT_Get_Kerning gives. A 'kern' table is read directly instead of
+ * probing every pair.
+ */
+bool getKerningPairs(Font& font, const unsigned* glyphIndices, int glyphCount, msdfgen::FontCoordinateScaling scaling, std::vector<MsdfgenKerningPair>& pairs);
+
+/* Variable font axes, owned by the font and valid until it is closed; null if the font has none */
+const std::vector<MsdfgenFontVariationAxis>* fontVariationAxes(Freetype& freetype, Font& font);
+
+/* Design coordinates of all axes in the order of fontVariationAxes; setting them empties the glyph cache */
+bool getFontVariationCoordinates(Freetype& freetype, Font& font, std::vector<double>& coordinates);
+bool setFontVariationCoordinates(Freetype& freetype, Font& font, const double* coordinates);
+bool setFontVariationAxis(Freetype& freetype, Font& font, const char* name, double coordinate);
+
+}
+
+#endif
+
+#endif /* MSDFGEN_C_FONT_H */
@@ -0,0 +1,112 @@
+/*
+ * Internal cache of decoded glyph outlines attached to a font
+ */
+
+#include "msdfgen_c_glyph_cache.h"
+
+using namespace msdfgen;
+
+namespace msdfgen_c {
+
+/* Rough per-entry cost of the list and hash map nodes */
+#define MSDFGEN_C_GLYPH_CACHE_NODE_BYTES 64
+
+static uint64_t glyphKey(unsigned glyphIndex, int scaling) {
+    return static_cast<uint64_t>(glyphIndex) << 8 | static_cast<uint64_t>(scaling & 0xff);
+}
+
+void GlyphCache::setBudget(size_t budget) {
+    budgetBytes = budget;
+    if (budget) {
+        evict(budget);
+    } else {
+        clear();
+    }
+}
+
+bool GlyphCache::load(PooledShape& shape, unsigned glyphIndex, int scaling, double* advance) {
+    if (!budgetBytes) return false;
+    auto found = index.find(glyphKey(glyphIndex, scaling));
+    if (found == index.end()) return false;
+    glyphs.splice(glyphs.begin(), glyphs, found->second);
+    const Glyph& glyph = *found->second;
+
+    shape.reset();
+    shape.setYAxisOrientation(glyph.yAxisOrientation);
+    const Point2* p = glyph.points.data();
+    const unsigned char* edgePoints = glyph.edgePoints.data();
+    for (int edgeCount : glyph.contourEdges) {
+        Contour& contour = shape.addRecycledContour();
+        for (int i = 0; i < edgeCount; i++) {
+            switch (*edgePoints) {
+                case 2: shape.addLinear(contour, p[0], p[1]); break;
+                case 3: shape.addQuadratic(contour, p[0], p[1], p[2]); break;
+                case 4: shape.addCubic(contour, p[0], p[1], p[2], p[3]); break;
+            }
+            p += *edgePoints++;
+        }
+    }
+    if (advance) {
+        *advance = glyph.advance;
+    }
+    return true;
+}
+
+void GlyphCache::store(const Shape& shape, unsigned glyphIndex, int scaling, double advance) {
+    if (!budgetBytes) return;
+    uint64_t key = glyphKey(glyphIndex, scaling);
+    if (index.count(key)) return;
+
+    Glyph glyph;
+    glyph.key = key;
+    glyph.advance = advance;
+    glyph.yAxisOrientation = shape.getYAxisOrientation();
+    glyph.contourEdges.reserve(shape.contours.size());
+    size_t edgeCount = 0, pointCount = 0;
+    for (const Contour& contour : shape.contours) {
+        edgeCount += contour.edges.size();
+        for (const EdgeHolder& edge : contour.edges) {
+            int count;
+            if (!segmentPoints(edge, count)) return;
+            pointCount += count;
+        }
+    }
+    glyph.edgePoints.reserve(edgeCount);
+    glyph.points.reserve(pointCount);
+    for (const Contour& contour : shape.contours) {
+        glyph.contourEdges.push_back(static_cast<int>(contour.edges.size()));
+        for (const EdgeHolder& edge : contour.edges) {
+            int count;
+            const Point2* points = segmentPoints(edge, count);
+            glyph.edgePoints.push_back(static_cast<unsigned char>(count));
+            glyph.points.insert(glyph.points.end(), points, points + count);
+        }
+    }
+    glyph.bytes = sizeof(Glyph) + MSDFGEN_C_GLYPH_CACHE_NODE_BYTES
+        + glyph.contourEdges.capacity() * sizeof(int)
+        + glyph.edgePoints.capacity()
+        + glyph.points.capacity() * sizeof(Point2);
+    if (glyph.bytes > budgetBytes) return;
+
+    evict(budgetBytes - glyph.bytes);
+    usedBytes += glyph.bytes;
+    glyphs.push_front(std::move(glyph));
+    index[key] = glyphs.begin();
+}
+
+void GlyphCache::clear() {
+    glyphs.clear();
+    index.clear();
+    usedBytes = 0;
+}
+
+/* Drops least recently used glyphs until at most budget bytes are in use */
+void GlyphCache::evict(size_t budget) {
+    while (usedBytes > budget && !glyphs.empty()) {
+        usedBytes -= glyphs.back().bytes;
+        index.erase(glyphs.back().key);
+        glyphs.pop_back();
+    }
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+ * Internal cache of decoded glyph outlines attached to a font
+ */
+
+#ifndef MSDFGEN_C_GLYPH_CACHE_H
+#define MSDFGEN_C_GLYPH_CACHE_H
+
+#include "msdfgen.h"
+#include "msdfgen_c_pooled_shape.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace msdfgen_c {
+
+/*
+ * Least recently used cache of glyph outlines and advances keyed by glyph index
+ * and coordinate scaling. Outlines are stored as flat arrays of segment control
+ * points and rebuilt in a PooledShape's recycled storage, so a hit neither calls
+ * FreeType nor allocates. The cache is disabled while its budget is 0. Like the
+ * font it belongs to, it is not synchronized.
+ */
+class GlyphCache {
+
+public:
+    GlyphCache() : budgetBytes(0), usedBytes(0) { }
+
+    /* Sets the memory budget in bytes, evicting entries as needed; 0 disables the cache and frees it */
+    void setBudget(size_t budget);
+
+    bool enabled() const {
+        return budgetBytes > 0;
+    }
+
+    /* Rebuilds a cached glyph into shape, replacing its contents. Returns false on a miss */
+    bool load(PooledShape& shape, unsigned glyphIndex, int scaling, double* advance);
+
+    /* Remembers the outline in shape as the glyph's outline */
+    void store(const msdfgen::Shape& shape, unsigned glyphIndex, int scaling, double advance);
+
+    void clear();
+
+private:
+    struct Glyph {
+        uint64_t key;
+        double advance;
+        msdfgen::YAxisOrientation yAxisOrientation;
+        std::vector<int> contourEdges;          /* Edge count of each contour */
+        std::vector<unsigned char> edgePoints;  /* Control point count of each edge: 2, 3 or 4 */
+        std::vector<msdfgen::Point2> points;
+        size_t bytes;
+    };
+
+    size_t budgetBytes;
+    size_t usedBytes;
+    std::list<Glyph> glyphs;    /* Most recently used first */
+    std::unordered_map<uint64_t, std::list<Glyph>::iterator> index;
+
+    void evict(size_t budget);
+
+};
+
+}
+
+#endif /* MSDFGEN_C_GLYPH_CACHE_H */
@@ -0,0 +1,71 @@
+/*
+ * Internal 128-bit structural hashing used to key cached generation results
+ */
+
+#ifndef MSDFGEN_C_HASH_H
+#define MSDFGEN_C_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace msdfgen_c {
+
+struct CacheKey {
+    uint64_t low;
+    uint64_t high;
+
+    bool operator==(const CacheKey& other) const {
+        return low == other.low && high == other.high;
+    }
+};
+
+struct CacheKeyHash {
+    size_t operator()(const CacheKey& key) const {
+        return static_cast<size_t>(key.low ^ (key.high >> 7));
+    }
+};
+
+/* Two independently seeded 64-bit lanes, each mixed with the splitmix64 finalizer */
+class Hasher {
+
+public:
+    Hasher() : low(0x243f6a8885a308d3ull), high(0x13198a2e03707344ull) { }
+
+    void add(uint64_t value) {
+        low = mix(low ^ value);
+        high = mix(high + value + 0x9e3779b97f4a7c15ull);
+    }
+
+    void add(int value) {
+        add(static_cast<uint64_t>(static_cast<int64_t>(value)));
+    }
+
+    void add(double value) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        add(bits);
+    }
+
+    CacheKey key() const {
+        CacheKey result = {mix(low ^ 0xa4093822299f31d0ull), mix(high ^ 0x082efa98ec4e6c89ull)};
+        return result;
+    }
+
+private:
+    uint64_t low, high;
+
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        x ^= x >> 31;
+        return x;
+    }
+
+};
+
+}
+
+#endif /* MSDFGEN_C_HASH_H */
@@ -0,0 +1,149 @@
+/*
+ * Internal background queue behind the asynchronous job API
+ */
+
+#include "msdfgen_c_job_queue.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace msdfgen_c {
+
+Job::Job(Work work, MsdfgenJobCallback callback, void* userData) :
+    work(std::move(work)), callback(callback), userData(userData), state(MSDFGEN_JOB_PENDING), result{nullptr, 0, 0, 0, 0}, references(1) { }
+
+Job::~Job() {
+    msdfgen_bitmap_free(&result);
+    JobQueue::instance().jobDestroyed();
+}
+
+MsdfgenJobStatus Job::status() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return state;
+}
+
+static bool isFinal(MsdfgenJobStatus status) {
+    return status != MSDFGEN_JOB_PENDING && status != MSDFGEN_JOB_RUNNING;
+}
+
+MsdfgenJobStatus Job::wait(int timeoutMilliseconds) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (timeoutMilliseconds < 0) {
+        finished.wait(lock, [this] { return isFinal(state); });
+    } else {
+        finished.wait_for(lock, std::chrono::milliseconds(timeoutMilliseconds), [this] { return isFinal(state); });
+    }
+    return state;
+}
+
+bool Job::takeResult(MsdfgenBitmap& bitmap) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state != MSDFGEN_JOB_DONE) return false;
+    bitmap = result;
+    result = MsdfgenBitmap{nullptr, 0, 0, 0, 0};
+    return true;
+}
+
+void Job::retain() {
+    references.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Job::release() {
+    if (references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this;
+    }
+}
+
+/* Publishes the final status, then reports it to the callback, which may release the caller's reference */
+void Job::finish(MsdfgenJobStatus status) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        state = status;
+    }
+    finished.notify_all();
+    if (callback) {
+        callback(this, status, userData);
+    }
+}
+
+JobQueue& JobQueue::instance() {
+    // Intentionally leaked, like the ThreadPool, so no worker is joined during static destruction
+    static JobQueue* queue = new JobQueue();
+    return *queue;
+}
+
+Job* JobQueue::submit(Job::Work work, MsdfgenJobCallback callback, void* userData, int maxJobs, int maxRunning) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (maxJobs > 0 && liveJobs >= maxJobs) return nullptr;
+    Job* job = new Job(std::move(work), callback, userData);
+    ++liveJobs;
+    job->retain();
+    pending.push_back(job);
+    runningLimit = std::max(maxRunning, 1);
+    while (static_cast<int>(workers.size()) < runningLimit) {
+        workers.emplace_back(&JobQueue::workerMain, this);
+    }
+    lock.unlock();
+    wakeUp.notify_one();
+    return job;
+}
+
+bool JobQueue::cancel(Job& job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::deque<Job*>::iterator it = std::find(pending.begin(), pending.end(), &job);
+        if (it == pending.end()) return false;
+        pending.erase(it);
+    }
+    job.finish(MSDFGEN_JOB_CANCELLED);
+    job.release();
+    return true;
+}
+
+int JobQueue::liveJobCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return liveJobs;
+}
+
+void JobQueue::jobDestroyed() {
+    std::lock_guard<std::mutex> lock(mutex);
+    --liveJobs;
+}
+
+void JobQueue::workerMain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wakeUp.wait(lock, [this] { return !pending.empty() && running < runningLimit; });
+        Job* job = pending.front();
+        pending.pop_front();
+        ++running;
+        lock.unlock();
+
+        {
+            std::lock_guard<std::mutex> jobLock(job->mutex);
+            job->state = MSDFGEN_JOB_RUNNING;
+        }
+        bool success = false;
+        MsdfgenBitmap result = {nullptr, 0, 0, 0, 0};
+        try {
+            success = job->work(result);
+        } catch (...) {
+            success = false;
+        }
+        job->work = nullptr;
+        {
+            std::lock_guard<std::mutex> jobLock(job->mutex);
+            job->result = result;
+        }
+        job->finish(success ? MSDFGEN_JOB_DONE : MSDFGEN_JOB_FAILED);
+        job->release();
+
+        lock.lock();
+        --running;
+        if (!pending.empty()) {
+            wakeUp.notify_one();
+        }
+    }
+}
+
+}
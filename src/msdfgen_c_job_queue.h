@@ -0,0 +1,104 @@
+/*
+ * Internal background queue behind the asynchronous job API
+ */
+
+#ifndef MSDFGEN_C_JOB_QUEUE_H
+#define MSDFGEN_C_JOB_QUEUE_H
+
+#include "msdfgen_c_api.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace msdfgen_c {
+
+/*
+ * One unit of background work producing a bitmap. A job is referenced by its
+ * MsdfgenJob handle and, while queued or running, by the queue; it is destroyed
+ * with its last reference, freeing a result that was not taken.
+ */
+class Job {
+
+public:
+    typedef std::function<bool(MsdfgenBitmap& result)> Work;
+
+    Job(Work work, MsdfgenJobCallback callback, void* userData);
+    ~Job();
+    Job(const Job&) = delete;
+    Job& operator=(const Job&) = delete;
+
+    MsdfgenJobStatus status();
+
+    /* Waits until the job is finished or timeoutMilliseconds have passed (< 0 waits indefinitely) */
+    MsdfgenJobStatus wait(int timeoutMilliseconds);
+
+    /* Moves the result out of a successfully finished job */
+    bool takeResult(MsdfgenBitmap& bitmap);
+
+    void retain();
+    void release();
+
+private:
+    friend class JobQueue;
+
+    Work work;
+    MsdfgenJobCallback callback;
+    void* userData;
+    std::mutex mutex;
+    std::condition_variable finished;
+    MsdfgenJobStatus state;
+    MsdfgenBitmap result;
+    std::atomic<int> references;
+
+    void finish(MsdfgenJobStatus status);
+
+};
+
+/*
+ * Process-wide FIFO of jobs served by dedicated background threads, separate from
+ * the ThreadPool so that queued jobs never delay the parallel entry points. The
+ * number of live jobs (queued, running or finished but not yet released) is
+ * capped at submission, which bounds the memory held by unclaimed results.
+ */
+class JobQueue {
+
+public:
+    /* Returns the shared queue; threads are spawned lazily and never joined */
+    static JobQueue& instance();
+
+    /*
+     * Queues a job, running at most maxRunning jobs at a time. Returns null if
+     * maxJobs jobs are already alive. The returned job holds one reference for the caller.
+     */
+    Job* submit(Job::Work work, MsdfgenJobCallback callback, void* userData, int maxJobs, int maxRunning);
+
+    /* Removes a job that has not started from the queue. Returns false if it has already started */
+    bool cancel(Job& job);
+
+    int liveJobCount();
+
+private:
+    friend class Job;
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::deque<Job*> pending;
+    std::vector<std::thread> workers;
+    int liveJobs;
+    int running;
+    int runningLimit;
+
+    JobQueue() : liveJobs(0), running(0), runningLimit(1) { }
+    void workerMain();
+    void jobDestroyed();
+
+};
+
+}
+
+#endif /* MSDFGEN_C_JOB_QUEUE_H */
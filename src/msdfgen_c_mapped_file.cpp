@@ -0,0 +1,120 @@
+/*
+ * Internal read-only memory mapping implementation
+ */
+
+#include "msdfgen_c_mapped_file.h"
+
+#include <filesystem>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace msdfgen_c {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : mappedData(nullptr), mappedSize(0), opened(false), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) { }
+
+bool MappedFile::open(const char* path) {
+    close();
+    std::filesystem::path filePath = std::filesystem::u8path(path);
+    fileHandle = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        close();
+        return false;
+    }
+    opened = true;
+    if (fileSize.QuadPart == 0) return true;
+    mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle) {
+        close();
+        return false;
+    }
+    mappedData = static_cast<const unsigned char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!mappedData) {
+        close();
+        return false;
+    }
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (mappedData) UnmapViewOfFile(mappedData);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+    mappedData = nullptr;
+    mappedSize = 0;
+    mappingHandle = nullptr;
+    fileHandle = INVALID_HANDLE_VALUE;
+    opened = false;
+}
+
+#else
+
+MappedFile::MappedFile() : mappedData(nullptr), mappedSize(0), opened(false) { }
+
+bool MappedFile::open(const char* path) {
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        return false;
+    }
+    opened = true;
+    if (fileStat.st_size > 0) {
+        void* mapping = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            opened = false;
+        } else {
+            mappedData = static_cast<const unsigned char*>(mapping);
+            mappedSize = static_cast<size_t>(fileStat.st_size);
+        }
+    }
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    return opened;
+}
+
+void MappedFile::close() {
+    if (mappedData) munmap(const_cast<unsigned char*>(mappedData), mappedSize);
+    mappedData = nullptr;
+    mappedSize = 0;
+    opened = false;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::isOpen() const {
+    return opened;
+}
+
+const unsigned char* MappedFile::data() const {
+    return mappedData;
+}
+
+size_t MappedFile::size() const {
+    return mappedSize;
+}
+
+}
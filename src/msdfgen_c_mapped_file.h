@@ -0,0 +1,41 @@
+/*
+ * Internal read-only memory mapping of a whole file
+ */
+
+#ifndef MSDFGEN_C_MAPPED_FILE_H
+#define MSDFGEN_C_MAPPED_FILE_H
+
+#include <cstddef>
+
+namespace msdfgen_c {
+
+class MappedFile {
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /* Maps the file at the UTF-8 path, replacing any previous mapping. An empty file maps to no data. */
+    bool open(const char* path);
+    void close();
+    bool isOpen() const;
+
+    const unsigned char* data() const;
+    size_t size() const;
+
+private:
+    const unsigned char* mappedData;
+    size_t mappedSize;
+    bool opened;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+};
+
+}
+
+#endif /* MSDFGEN_C_MAPPED_FILE_H */
@@ -0,0 +1,92 @@
+/*
+ * Internal in-process cache of generated distance fields
+ */
+
+#include "msdfgen_c_memory_cache.h"
+
+namespace msdfgen_c {
+
+/* Rough per-entry cost of the list and hash map nodes */
+#define MSDFGEN_C_MEMORY_CACHE_NODE_BYTES 96
+
+MemoryCache& MemoryCache::instance() {
+    static MemoryCache* cache = new MemoryCache();
+    return *cache;
+}
+
+void MemoryCache::setBudget(size_t budget) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budgetBytes = budget;
+    evict(budget);
+}
+
+bool MemoryCache::enabled() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return budgetBytes > 0;
+}
+
+bool MemoryCache::load(const CacheKey& key, size_t byteSize, const std::function<void(const unsigned char*)>& consume) {
+    std::shared_ptr<const std::vector<unsigned char> > payload;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!budgetBytes) return false;
+        auto found = index.find(key);
+        if (found == index.end() || found->second->payload->size() != byteSize) {
+            ++misses;
+            return false;
+        }
+        entries.splice(entries.begin(), entries, found->second);
+        payload = found->second->payload;
+        ++hits;
+    }
+    consume(payload->data());
+    return true;
+}
+
+void MemoryCache::store(const CacheKey& key, const void* data, size_t byteSize) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!budgetBytes || index.count(key) || byteSize + MSDFGEN_C_MEMORY_CACHE_NODE_BYTES > budgetBytes) return;
+    }
+    // The copy is made outside the lock; a concurrent store of the same key is dropped below
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    Entry entry;
+    entry.key = key;
+    entry.payload = std::make_shared<const std::vector<unsigned char> >(bytes, bytes + byteSize);
+    entry.bytes = byteSize + MSDFGEN_C_MEMORY_CACHE_NODE_BYTES;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (index.count(key) || entry.bytes > budgetBytes) return;
+    evict(budgetBytes - entry.bytes);
+    usedBytes += entry.bytes;
+    entries.push_front(std::move(entry));
+    index[key] = entries.begin();
+}
+
+void MemoryCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    usedBytes = 0;
+    hits = 0;
+    misses = 0;
+}
+
+void MemoryCache::readCounters(uint64_t& hitCount, uint64_t& missCount, uint64_t& entryCount, uint64_t& bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    hitCount = hits;
+    missCount = misses;
+    entryCount = entries.size();
+    bytes = usedBytes;
+}
+
+/* Drops least recently used entries until at most budget bytes are in use */
+void MemoryCache::evict(size_t budget) {
+    while (usedBytes > budget && !entries.empty()) {
+        usedBytes -= entries.back().bytes;
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+ * Internal in-process cache of generated distance fields
+ */
+
+#ifndef MSDFGEN_C_MEMORY_CACHE_H
+#define MSDFGEN_C_MEMORY_CACHE_H
+
+#include "msdfgen_c_hash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace msdfgen_c {
+
+/*
+ * Least recently used cache of packed generation results in memory, keyed like
+ * the DiskCache. Payloads are shared and immutable, so a hit is copied out after
+ * the lock is released and concurrent lookups only contend for the bookkeeping.
+ * The cache is disabled while its budget is 0.
+ */
+class MemoryCache {
+
+public:
+    static MemoryCache& instance();
+
+    /* Sets the memory budget in bytes, evicting entries as needed; 0 disables the cache and frees it */
+    void setBudget(size_t budget);
+
+    bool enabled() const;
+
+    /* Calls consume with the cached payload if present with exactly byteSize bytes, counting a hit or a miss */
+    bool load(const CacheKey& key, size_t byteSize, const std::function<void(const unsigned char*)>& consume);
+    void store(const CacheKey& key, const void* data, size_t byteSize);
+
+    /* Drops all entries and zeroes the counters */
+    void clear();
+
+    void readCounters(uint64_t& hits, uint64_t& misses, uint64_t& entryCount, uint64_t& bytes);
+
+private:
+    struct Entry {
+        CacheKey key;
+        std::shared_ptr<const std::vector<unsigned char> > payload;
+        size_t bytes;
+    };
+
+    mutable std::mutex mutex;
+    size_t budgetBytes;
+    size_t usedBytes;
+    uint64_t hits;
+    uint64_t misses;
+    std::list<Entry> entries;   /* Most recently used first */
+    std::unordered_map<CacheKey, std::list<Entry>::iterator, CacheKeyHash> index;
+
+    MemoryCache() : budgetBytes(0), usedBytes(0), hits(0), misses(0) { }
+    void evict(size_t budget);
+
+};
+
+}
+
+#endif /* MSDFGEN_C_MEMORY_CACHE_H */
@@ -0,0 +1,128 @@
+/*
+ * Internal shape with recycled contour and edge segment storage
+ */
+
+#include "msdfgen_c_pooled_shape.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace msdfgen;
+
+namespace msdfgen_c {
+
+static const YAxisOrientation defaultYAxisOrientation = Shape().getYAxisOrientation();
+
+/* Moves the segment out of edge into a spare holder of the same type */
+static void takeEdge(EdgeHolder& edge, std::vector<EdgeHolder>& spares) {
+    spares.emplace_back();
+    EdgeHolder::swap(spares.back(), edge);
+}
+
+/*
+ * Appends an edge to the contour, reusing a spare segment if there is one.
+ * EdgeHolder copies clone their segment, so holders are only ever swapped.
+ */
+template <class Segment>
+static void addEdge(Contour& contour, std::vector<EdgeHolder>& spares, const Segment& segment) {
+    EdgeHolder& edge = contour.addEdge();
+    if (spares.empty()) {
+        EdgeHolder fresh(new Segment(segment));
+        EdgeHolder::swap(edge, fresh);
+        return;
+    }
+    EdgeHolder::swap(edge, spares.back());
+    spares.pop_back();
+    *static_cast<Segment*>(static_cast<EdgeSegment*>(edge)) = segment;
+}
+
+void PooledShape::reset() {
+    size_t edgeCount = 0;
+    for (const Contour& contour : contours) {
+        edgeCount += contour.edges.size();
+    }
+    reserveSpares(edgeCount);
+    spareContours.reserve(spareContours.size() + contours.size());
+
+    // Recycled in reverse so that the next outline reuses the contours in their previous order
+    while (!contours.empty()) {
+        recycleLastContour();
+    }
+    setYAxisOrientation(defaultYAxisOrientation);
+}
+
+Contour& PooledShape::addRecycledContour() {
+    if (spareContours.empty()) {
+        return addContour();
+    }
+    contours.push_back(std::move(spareContours.back()));
+    spareContours.pop_back();
+    return contours.back();
+}
+
+void PooledShape::recycleLastContour() {
+    if (contours.empty()) return;
+    reserveSpares(contours.back().edges.size());
+    recycleContour(contours.back());
+    spareContours.push_back(std::move(contours.back()));
+    contours.pop_back();
+}
+
+void PooledShape::addLinear(Contour& contour, Point2 p0, Point2 p1) {
+    addEdge(contour, spareLinear, LinearSegment(p0, p1));
+}
+
+void PooledShape::addQuadratic(Contour& contour, Point2 p0, Point2 p1, Point2 p2) {
+    addEdge(contour, spareQuadratic, QuadraticSegment(p0, p1, p2));
+}
+
+void PooledShape::addCubic(Contour& contour, Point2 p0, Point2 p1, Point2 p2, Point2 p3) {
+    addEdge(contour, spareCubic, CubicSegment(p0, p1, p2, p3));
+}
+
+/* Growing a vector of EdgeHolder clones every segment in it, so room is made up front and in large steps */
+static void reserveHolders(std::vector<EdgeHolder>& holders, size_t additional) {
+    size_t required = holders.size() + additional;
+    if (required > holders.capacity()) {
+        holders.reserve(std::max(required, 2 * holders.capacity()));
+    }
+}
+
+void PooledShape::reserveSpares(size_t edgeCount) {
+    reserveHolders(spareLinear, edgeCount);
+    reserveHolders(spareQuadratic, edgeCount);
+    reserveHolders(spareCubic, edgeCount);
+}
+
+void PooledShape::recycleContour(Contour& contour) {
+    for (EdgeHolder& edge : contour.edges) {
+        const EdgeSegment* segment = edge;
+        if (dynamic_cast<const LinearSegment*>(segment)) {
+            takeEdge(edge, spareLinear);
+        } else if (dynamic_cast<const QuadraticSegment*>(segment)) {
+            takeEdge(edge, spareQuadratic);
+        } else if (dynamic_cast<const CubicSegment*>(segment)) {
+            takeEdge(edge, spareCubic);
+        }
+    }
+    contour.edges.clear();
+}
+
+const Point2* segmentPoints(const EdgeSegment* segment, int& pointCount) {
+    if (const LinearSegment* linear = dynamic_cast<const LinearSegment*>(segment)) {
+        pointCount = 2;
+        return linear->p;
+    }
+    if (const QuadraticSegment* quadratic = dynamic_cast<const QuadraticSegment*>(segment)) {
+        pointCount = 3;
+        return quadratic->p;
+    }
+    if (const CubicSegment* cubic = dynamic_cast<const CubicSegment*>(segment)) {
+        pointCount = 4;
+        return cubic->p;
+    }
+    pointCount = 0;
+    return nullptr;
+}
+
+}
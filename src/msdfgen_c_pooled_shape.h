@@ -0,0 +1,55 @@
+/*
+ * Internal shape with recycled contour and edge segment storage
+ */
+
+#ifndef MSDFGEN_C_POOLED_SHAPE_H
+#define MSDFGEN_C_POOLED_SHAPE_H
+
+#include "msdfgen.h"
+
+#include <vector>
+
+namespace msdfgen_c {
+
+/*
+ * Shape behind every MsdfgenShape handle. reset() keeps the contours, their edge
+ * vectors and the edge segments themselves, and the add functions hand them out
+ * again, so a shape that is repeatedly refilled with similar outlines stops
+ * allocating. A recycled segment is overwritten with a freshly constructed segment
+ * of the same type, which keeps msdfgen's constructor adjustments of degenerate
+ * control points. Edges added by msdfgen itself (SVG import, normalization) are
+ * recycled the same way on the next reset.
+ */
+class PooledShape : public msdfgen::Shape {
+
+public:
+    /* Removes all contours, keeping their storage, and restores the default Y axis orientation */
+    void reset();
+
+    /* Appends an empty contour */
+    msdfgen::Contour& addRecycledContour();
+
+    /* Removes the last contour, keeping its storage */
+    void recycleLastContour();
+
+    void addLinear(msdfgen::Contour& contour, msdfgen::Point2 p0, msdfgen::Point2 p1);
+    void addQuadratic(msdfgen::Contour& contour, msdfgen::Point2 p0, msdfgen::Point2 p1, msdfgen::Point2 p2);
+    void addCubic(msdfgen::Contour& contour, msdfgen::Point2 p0, msdfgen::Point2 p1, msdfgen::Point2 p2, msdfgen::Point2 p3);
+
+private:
+    std::vector<msdfgen::Contour> spareContours;
+    std::vector<msdfgen::EdgeHolder> spareLinear;
+    std::vector<msdfgen::EdgeHolder> spareQuadratic;
+    std::vector<msdfgen::EdgeHolder> spareCubic;
+
+    void reserveSpares(size_t edgeCount);
+    void recycleContour(msdfgen::Contour& contour);
+
+};
+
+/* Returns the control points of a segment, including both endpoints, or null for unknown segment types */
+const msdfgen::Point2* segmentPoints(const msdfgen::EdgeSegment* segment, int& pointCount);
+
+}
+
+#endif /* MSDFGEN_C_POOLED_SHAPE_H */
@@ -0,0 +1,98 @@
+/*
+ * Internal per-thread instrumentation counters behind msdfgen_stats_*
+ */
+
+#include "msdfgen_c_stats.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace msdfgen_c {
+
+std::atomic<bool> statsEnabled(false);
+
+/* Counters of live threads, totals of finished threads and the totals at the last reset */
+struct Registry {
+    std::mutex mutex;
+    std::vector<StatCounters*> threads;
+    MsdfgenStats retired;
+    MsdfgenStats baseline;
+};
+
+/* Never destroyed, as threads may finish after static destructors have run */
+static Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+static void accumulate(MsdfgenStats& totals, const StatCounters& counters) {
+    for (int i = 0; i < MSDFGEN_STAGE_COUNT; i++) {
+        totals.stageNanoseconds[i] += counters.stageNanoseconds[i].load(std::memory_order_relaxed);
+        totals.stageCalls[i] += counters.stageCalls[i].load(std::memory_order_relaxed);
+    }
+    totals.pixelsGenerated += counters.pixelsGenerated.load(std::memory_order_relaxed);
+    totals.edgeEvaluations += counters.edgeEvaluations.load(std::memory_order_relaxed);
+    totals.correctedPixels += counters.correctedPixels.load(std::memory_order_relaxed);
+}
+
+/* Sum over all threads, with the registry locked */
+static MsdfgenStats totals(const Registry& registry) {
+    MsdfgenStats sum = registry.retired;
+    for (const StatCounters* counters : registry.threads) {
+        accumulate(sum, *counters);
+    }
+    return sum;
+}
+
+/* Owns the counters of one thread and folds them into the retired totals when it exits */
+struct ThreadRegistration {
+    StatCounters* counters;
+
+    ThreadRegistration() : counters(new StatCounters()) {
+        Registry& instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        instance.threads.push_back(counters);
+    }
+
+    ~ThreadRegistration() {
+        Registry& instance = registry();
+        {
+            std::lock_guard<std::mutex> lock(instance.mutex);
+            accumulate(instance.retired, *counters);
+            instance.threads.erase(std::find(instance.threads.begin(), instance.threads.end(), counters));
+        }
+        delete counters;
+    }
+};
+
+StatCounters& threadStats() {
+    static thread_local ThreadRegistration registration;
+    return *registration.counters;
+}
+
+void setStatsEnabled(bool enabled) {
+    statsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void readStats(MsdfgenStats& stats) {
+    Registry& instance = registry();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    MsdfgenStats sum = totals(instance);
+    for (int i = 0; i < MSDFGEN_STAGE_COUNT; i++) {
+        stats.stageNanoseconds[i] = sum.stageNanoseconds[i] - instance.baseline.stageNanoseconds[i];
+        stats.stageCalls[i] = sum.stageCalls[i] - instance.baseline.stageCalls[i];
+    }
+    stats.pixelsGenerated = sum.pixelsGenerated - instance.baseline.pixelsGenerated;
+    stats.edgeEvaluations = sum.edgeEvaluations - instance.baseline.edgeEvaluations;
+    stats.correctedPixels = sum.correctedPixels - instance.baseline.correctedPixels;
+}
+
+/* Counters are only ever written by their own thread, so a reset moves the baseline instead */
+void resetStats() {
+    Registry& instance = registry();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    instance.baseline = totals(instance);
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Internal per-thread instrumentation counters behind msdfgen_stats_*
+ */
+
+#ifndef MSDFGEN_C_STATS_H
+#define MSDFGEN_C_STATS_H
+
+#include "msdfgen_c_api.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace msdfgen_c {
+
+/*
+ * Counters of one thread. Only the owning thread writes them, so updates are plain
+ * relaxed load-store pairs; readers on other threads see each value either before
+ * or after an update.
+ */
+struct StatCounters {
+    std::atomic<unsigned long long> stageNanoseconds[MSDFGEN_STAGE_COUNT];
+    std::atomic<unsigned long long> stageCalls[MSDFGEN_STAGE_COUNT];
+    std::atomic<unsigned long long> pixelsGenerated;
+    std::atomic<unsigned long long> edgeEvaluations;
+    std::atomic<unsigned long long> correctedPixels;
+};
+
+extern std::atomic<bool> statsEnabled;
+
+inline bool statsActive() {
+    return statsEnabled.load(std::memory_order_relaxed);
+}
+
+/* Counters of the calling thread, registered on first use */
+StatCounters& threadStats();
+
+inline void addStat(std::atomic<unsigned long long>& counter, unsigned long long value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+/* Adds the time until the end of the scope to a stage if counting was enabled at its start */
+class StageTimer {
+
+public:
+    explicit StageTimer(MsdfgenStage stage) : stage(statsActive() ? stage : MSDFGEN_STAGE_COUNT) {
+        if (this->stage != MSDFGEN_STAGE_COUNT) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~StageTimer() {
+        if (stage != MSDFGEN_STAGE_COUNT) {
+            StatCounters& counters = threadStats();
+            addStat(counters.stageNanoseconds[stage], std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+            addStat(counters.stageCalls[stage], 1);
+        }
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    MsdfgenStage stage;
+    std::chrono::steady_clock::time_point start;
+
+};
+
+void setStatsEnabled(bool enabled);
+void readStats(MsdfgenStats& stats);
+void resetStats();
+
+}
+
+#endif /* MSDFGEN_C_STATS_H */
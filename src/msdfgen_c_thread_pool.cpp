@@ -0,0 +1,160 @@
+/*
+ * Internal work-stealing thread pool implementation
+ */
+
+#include "msdfgen_c_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace msdfgen_c {
+
+static thread_local bool runningTask = false;
+
+struct ThreadPool::Loop {
+    const std::function<void(int)>* task;
+    int slots;
+    int claimedSlots;
+    std::vector<std::deque<int> > queues;
+    std::unique_ptr<std::mutex[]> queueMutexes;
+    std::atomic<int> remaining;
+    std::mutex doneMutex;
+    std::condition_variable done;
+
+    Loop(const std::function<void(int)>* task, int slots, int count) :
+        task(task), slots(slots), claimedSlots(1), queues(slots), queueMutexes(new std::mutex[slots]), remaining(count) { }
+
+    /* Takes the next index from the slot's own queue, or steals the cheapest one from another slot */
+    bool pop(int slot, int& index) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutexes[slot]);
+            if (!queues[slot].empty()) {
+                index = queues[slot].front();
+                queues[slot].pop_front();
+                return true;
+            }
+        }
+        for (int i = 1; i < slots; ++i) {
+            int victim = (slot + i) % slots;
+            std::lock_guard<std::mutex> lock(queueMutexes[victim]);
+            if (!queues[victim].empty()) {
+                index = queues[victim].back();
+                queues[victim].pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+ThreadPool& ThreadPool::instance() {
+    // Intentionally leaked so that no worker has to be joined during static destruction or library unload
+    static ThreadPool* pool = new ThreadPool();
+    return *pool;
+}
+
+int ThreadPool::hardwareThreads() {
+    unsigned count = std::thread::hardware_concurrency();
+    return count > 0 ? static_cast<int>(count) : 1;
+}
+
+bool ThreadPool::insideTask() {
+    return runningTask;
+}
+
+void ThreadPool::parallelFor(int count, const double* costs, int maxThreads, const std::function<void(int)>& task) {
+    if (count <= 0) return;
+
+    std::vector<int> order(count);
+    for (int i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    if (costs) {
+        std::stable_sort(order.begin(), order.end(), [costs](int a, int b) {
+            return costs[a] > costs[b];
+        });
+    }
+
+    if (maxThreads <= 0) {
+        maxThreads = hardwareThreads();
+    }
+    int slots = std::min(maxThreads, count);
+    if (slots <= 1 || runningTask) {
+        bool wasRunningTask = runningTask;
+        runningTask = true;
+        for (int index : order) {
+            task(index);
+        }
+        runningTask = wasRunningTask;
+        return;
+    }
+
+    // Deal the tasks out round-robin so that every queue starts with its most expensive work
+    std::shared_ptr<Loop> loop = std::make_shared<Loop>(&task, slots, count);
+    for (int i = 0; i < count; i++) {
+        loop->queues[i % slots].push_back(order[i]);
+    }
+
+    ensureWorkers(slots - 1);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        openLoops.push_back(loop);
+    }
+    wakeUp.notify_all();
+
+    runningTask = true;
+    participate(*loop, 0);
+    runningTask = false;
+
+    {
+        std::unique_lock<std::mutex> lock(loop->doneMutex);
+        loop->done.wait(lock, [&loop] { return loop->remaining.load() == 0; });
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::deque<std::shared_ptr<Loop> >::iterator it = std::find(openLoops.begin(), openLoops.end(), loop);
+        if (it != openLoops.end()) {
+            openLoops.erase(it);
+        }
+    }
+}
+
+void ThreadPool::ensureWorkers(int count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    while (static_cast<int>(workers.size()) < count) {
+        workers.emplace_back(&ThreadPool::workerMain, this);
+    }
+}
+
+void ThreadPool::workerMain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wakeUp.wait(lock, [this] { return !openLoops.empty(); });
+        std::shared_ptr<Loop> loop = openLoops.front();
+        int slot = loop->claimedSlots++;
+        if (loop->claimedSlots >= loop->slots) {
+            openLoops.pop_front();
+        }
+        lock.unlock();
+
+        runningTask = true;
+        participate(*loop, slot);
+        runningTask = false;
+
+        loop.reset();
+        lock.lock();
+    }
+}
+
+void ThreadPool::participate(Loop& loop, int slot) {
+    int index;
+    while (loop.pop(slot, index)) {
+        (*loop.task)(index);
+        if (loop.remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(loop.doneMutex);
+            loop.done.notify_all();
+        }
+    }
+}
+
+}
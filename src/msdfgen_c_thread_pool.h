@@ -0,0 +1,61 @@
+/*
+ * Internal work-stealing thread pool used by the parallel entry points of the C API
+ */
+
+#ifndef MSDFGEN_C_THREAD_POOL_H
+#define MSDFGEN_C_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace msdfgen_c {
+
+/*
+ * Process-wide pool of worker threads. Work is submitted as an indexed loop;
+ * every participating thread owns a queue of indices and steals from the back
+ * of the other queues once its own runs dry. The calling thread always takes
+ * part, so a loop makes progress even when all workers are busy elsewhere.
+ */
+class ThreadPool {
+
+public:
+    /* Returns the shared pool; worker threads are spawned lazily */
+    static ThreadPool& instance();
+
+    /* Number of hardware threads, at least 1 */
+    static int hardwareThreads();
+
+    /* True when called from inside a task running on the pool */
+    static bool insideTask();
+
+    /*
+     * Runs task(i) for every i in [0, count) on up to maxThreads threads, including
+     * the caller, and returns when all tasks are finished. If costs is not null,
+     * tasks with a higher cost are started first. Nested calls made from inside
+     * a task run serially on the calling thread.
+     */
+    void parallelFor(int count, const double* costs, int maxThreads, const std::function<void(int)>& task);
+
+private:
+    struct Loop;
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::deque<std::shared_ptr<Loop> > openLoops;
+    std::vector<std::thread> workers;
+
+    ThreadPool() = default;
+    void ensureWorkers(int count);
+    void workerMain();
+    static void participate(Loop& loop, int slot);
+
+};
+
+}
+
+#endif /* MSDFGEN_C_THREAD_POOL_H */